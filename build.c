@@ -27,6 +27,12 @@ int main(void)
     // set_target("qwm-test", "bin-test", "build-test");
 
     AM_USE_LIB("xcb");
+    AM_USE_LIB("xcb-sync");
+    AM_USE_LIB("xcb-randr");
+    AM_USE_LIB("xcb-screensaver");
+    AM_USE_LIB("xcb-dpms");
+    AM_USE_LIB("pthread");
+    // AM_USE_LIB("xcb-shm"); // with USE_SHM_BAR
 
     AM_BUILD(BUILD_EXE, true);
     AM_RESET();
@@ -8,6 +8,9 @@
 #define BORDER_FOCUS 0x6699CC
 #define BORDER_UNFOCUS 0x222222
 
+// Core X font (see xlsfonts for names), proportional fonts work too
+#define FONT "fixed"
+
 #define TASKBAR_COLOR 0x444444
 #define TASKBAR_FONT_COLOR 0xDDDDDD
 
@@ -17,11 +20,30 @@
 #define LAUNCHER_FG_COLOR 0x666666
 #define LAUNCHER_FONT_COLOR 0xDDDDDD
 
+// Floating windows: modifier + left drag moves, + right drag resizes
+#define DRAG_MODIFIER KEY_SUPER
+#define DRAG_MOVE_BUTTON XCB_BUTTON_INDEX_1
+#define DRAG_RESIZE_BUTTON XCB_BUTTON_INDEX_3
+
+// Optional features (0 = compiled out)
+#define USE_IPC 0 // unix socket at $XDG_RUNTIME_DIR/qwm.sock, see ipc.h
+#define USE_SHM_BAR 0 // client side bar, link xcb-shm in build.c, see raster.h
+
+// Pre-started apps: count instances stay started but unmapped, claiming
+// one only maps it. The class must be unique to the pool, rules for the
+// plain app class don't match pooled windows.
+static const pool_app_t my_pool[] = {
+    {"qwm-pool-kitty", "kitty --class qwm-pool-kitty", 1},
+};
+
+// Scratchpad, floating, toggled with toggle_scratchpad
+#define SCRATCHPAD_CLASS "qwm-scratchpad"
+#define SCRATCHPAD_CMD "kitty --class qwm-scratchpad"
+
 // application spawning configuration
 static inline void spawn_terminal(struct qwm_t *qwm)
 {
-    (void)qwm;
-    spawn("kitty", NULL);
+    pool_claim(qwm, 0); // my_pool[0]
 }
 
 static inline void spawn_browser(struct qwm_t *qwm)
@@ -64,12 +86,22 @@ static const keybind_t my_keybinds[] = {
     {KEY_SUPER, KEY_J, focus_prev},
     {KEY_SUPER, KEY_S, swap_master},
 
+    {KEY_SUPER, KEY_PERIOD, focus_next_monitor},
+    {KEY_SUPER | KEY_SHIFT, KEY_PERIOD, move_to_next_monitor},
+
     {KEY_SUPER, KEY_SPACE, spawn_launcher},
     {KEY_SUPER, KEY_ENTER, spawn_terminal},
+    {KEY_SUPER, KEY_MINUS, toggle_scratchpad},
     {KEY_SUPER, KEY_B, spawn_browser},
     {KEY_SUPER, KEY_P, spawn_screenshot},
     {KEY_SUPER, KEY_O, spawn_fm},
 };
 
+static const rule_t my_rules[] = {
+    // class        instance  title  ws  float  focus
+    {"Pavucontrol", NULL, NULL, 0, 1, 1},
+    {"flameshot", NULL, NULL, 0, 1, 1},
+};
+
 #endif // CONFIG_H
 
@@ -1,16 +1,200 @@
-#include "client.h"
 #include "qwm.h"
+#include "client.h"
+#include "util.h"
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <xcb/xcbext.h> // xcb_poll_for_reply
+
+// give up on a client that doesn't ack a sync request in time
+#define SYNC_TIMEOUT_MS 200
+
+// terminals retitle on every command, coalesce bursts into one fetch
+#define TITLE_DEBOUNCE_MS 150
+
+// both replies are read from the event loop, never waited on
+static void client_title_request(struct qwm_t *wm, client_t *c)
+{
+    c->net_name_ck =
+        xcb_get_property(wm->conn, 0, c->win, wm->atom.net_wm_name,
+                         XCB_GET_PROPERTY_TYPE_ANY, 0, sizeof(c->title) / 4);
+    c->name_ck = xcb_get_property(wm->conn, 0, c->win, XCB_ATOM_WM_NAME,
+                                  XCB_GET_PROPERTY_TYPE_ANY, 0,
+                                  sizeof(c->title) / 4);
+    c->title_inflight = 1;
+}
+
+// 8 bit core fonts can't draw UTF-8, a multibyte sequence becomes '?'
+static uint8_t title_copy(char *dst, uint32_t cap, const char *src,
+                          uint32_t len)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < len && n + 1 < cap; ++i)
+    {
+        uint8_t b = (uint8_t)src[i];
+        if (b == 0) break;
+        if (b >= 0x80 && b < 0xC0) continue; // continuation byte
+        dst[n++] = b >= 0x80 ? '?' : (char)b;
+    }
+    dst[n] = '\0';
+    return (uint8_t)n;
+}
+
+// returns 1 when the title changed
+static int32_t client_title_take(struct qwm_t *wm, client_t *c)
+{
+    // replies come in order, WM_NAME went out last
+    xcb_get_property_reply_t *name = NULL;
+    xcb_generic_error_t *err = NULL;
+    if (!xcb_poll_for_reply(wm->conn, c->name_ck.sequence, (void **)&name,
+                            &err))
+        return 0;
+    free(err);
+
+    xcb_get_property_reply_t *net =
+        xcb_get_property_reply(wm->conn, c->net_name_ck, NULL);
+    c->title_inflight = 0;
+
+    xcb_get_property_reply_t *use = name;
+    if (net && xcb_get_property_value_length(net) > 0) use = net;
+
+    char buf[sizeof(c->title)];
+    uint8_t len = 0;
+    buf[0] = '\0';
+    if (use && use->format == 8)
+    {
+        len = title_copy(buf, sizeof(buf), xcb_get_property_value(use),
+                         (uint32_t)xcb_get_property_value_length(use));
+    }
+    free(net);
+    free(name);
+
+    if (len == c->title_len && memcmp(buf, c->title, len) == 0) return 0;
+
+    memcpy(c->title, buf, len + 1u);
+    c->title_len = len;
+    c->title_gen++;
+    return 1;
+}
+
+static void client_sync_init(struct qwm_t *wm, client_t *c)
+{
+    if (!wm->sync_event_base) return;
+
+    xcb_get_property_cookie_t proto_ck = xcb_get_property(
+        wm->conn, 0, c->win, wm->atom.wm_protocols, XCB_ATOM_ATOM, 0, 64);
+    xcb_get_property_cookie_t counter_ck =
+        xcb_get_property(wm->conn, 0, c->win,
+                         wm->atom.net_wm_sync_request_counter,
+                         XCB_ATOM_CARDINAL, 0, 1);
+
+    xcb_get_property_reply_t *proto =
+        xcb_get_property_reply(wm->conn, proto_ck, NULL);
+    xcb_get_property_reply_t *counter =
+        xcb_get_property_reply(wm->conn, counter_ck, NULL);
+
+    int32_t supported = 0;
+    if (proto && proto->format == 32 && proto->type == XCB_ATOM_ATOM)
+    {
+        xcb_atom_t *atoms = (xcb_atom_t *)xcb_get_property_value(proto);
+        int n = xcb_get_property_value_length(proto) / 4;
+        for (int i = 0; i < n; ++i)
+        {
+            if (atoms[i] == wm->atom.net_wm_sync_request) supported = 1;
+        }
+    }
 
-client_t *client_init(struct qwm_t *wm, xcb_window_t win)
+    if (supported && counter && counter->format == 32 &&
+        xcb_get_property_value_length(counter) >= 4)
+    {
+        c->sync_counter = *(uint32_t *)xcb_get_property_value(counter);
+    }
+
+    free(proto);
+    free(counter);
+    if (!c->sync_counter) return;
+
+    // our values must start above whatever the client put in the counter
+    xcb_sync_query_counter_reply_t *q = xcb_sync_query_counter_reply(
+        wm->conn, xcb_sync_query_counter(wm->conn, c->sync_counter), NULL);
+    if (!q)
+    {
+        c->sync_counter = 0;
+        return;
+    }
+    c->sync_value = ((uint64_t)(uint32_t)q->counter_value.hi << 32) |
+                    q->counter_value.lo;
+    free(q);
+
+    // fires once the counter reaches the value of the last request
+    c->sync_alarm = xcb_generate_id(wm->conn);
+    uint32_t values[] = {c->sync_counter,
+                         XCB_SYNC_VALUETYPE_ABSOLUTE,
+                         (uint32_t)(c->sync_value >> 32),
+                         (uint32_t)c->sync_value,
+                         XCB_SYNC_TESTTYPE_POSITIVE_COMPARISON,
+                         0,
+                         0,
+                         1};
+    xcb_sync_create_alarm(wm->conn, c->sync_alarm,
+                          XCB_SYNC_CA_COUNTER | XCB_SYNC_CA_VALUE_TYPE |
+                              XCB_SYNC_CA_VALUE | XCB_SYNC_CA_TEST_TYPE |
+                              XCB_SYNC_CA_DELTA | XCB_SYNC_CA_EVENTS,
+                          values);
+}
+
+static void client_send_configure(struct qwm_t *wm, client_t *c)
+{
+    // only resizes make the client repaint, moves go straight through
+    if (c->sync_counter && (c->w != c->sent_w || c->h != c->sent_h))
+    {
+        c->sync_value++;
+
+        uint32_t alarm_value[] = {(uint32_t)(c->sync_value >> 32),
+                                  (uint32_t)c->sync_value};
+        xcb_sync_change_alarm(wm->conn, c->sync_alarm, XCB_SYNC_CA_VALUE,
+                              alarm_value);
+
+        xcb_client_message_event_t ev = {
+            .response_type = XCB_CLIENT_MESSAGE,
+            .format = 32,
+            .window = c->win,
+            .type = wm->atom.wm_protocols,
+            .data.data32 = {wm->atom.net_wm_sync_request, XCB_CURRENT_TIME,
+                            (uint32_t)c->sync_value,
+                            (uint32_t)(c->sync_value >> 32), 0}};
+        xcb_send_event(wm->conn, 0, c->win, XCB_EVENT_MASK_NO_EVENT,
+                       (char *)&ev);
+
+        c->sync_waiting = 1;
+        c->sync_since_ms = monotonic_ms();
+    }
+
+    c->sent_w = c->w;
+    c->sent_h = c->h;
+
+    uint32_t values[] = {c->x, c->y, c->w, c->h};
+
+    uint16_t mask = XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y |
+                    XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT;
+
+    xcb_configure_window(wm->conn, c->win, mask, values);
+}
+
+client_t *client_init(struct qwm_t *wm, xcb_window_t win, uint16_t ws)
 {
     client_t *c = calloc(1, sizeof(client_t));
     if (!c) return NULL;
 
+    xcb_get_geometry_cookie_t geo_ck = xcb_get_geometry(wm->conn, win);
+    xcb_get_property_cookie_t state_ck =
+        xcb_get_property(wm->conn, 0, win, wm->atom.net_wm_state,
+                         XCB_ATOM_ATOM, 0, 32);
+
     c->win = win;
-    c->workspace = wm->current_ws;
+    c->workspace = ws;
     c->next = wm->workspaces[c->workspace].clients;
     wm->workspaces[c->workspace].clients = c;
 
@@ -19,6 +203,37 @@ client_t *client_init(struct qwm_t *wm, xcb_window_t win)
                          XCB_EVENT_MASK_PROPERTY_CHANGE};
 
     xcb_change_window_attributes(wm->conn, win, XCB_CW_EVENT_MASK, values);
+    ewmh_client_add(wm, c);
+    wm->managed_count++;
+
+    xcb_get_geometry_reply_t *geo =
+        xcb_get_geometry_reply(wm->conn, geo_ck, NULL);
+    c->fw = geo ? geo->width : 0;
+    c->fh = geo ? geo->height : 0;
+    free(geo);
+
+    // clients may ask for fullscreen before they are mapped
+    xcb_get_property_reply_t *state =
+        xcb_get_property_reply(wm->conn, state_ck, NULL);
+    if (state && state->format == 32)
+    {
+        xcb_atom_t *atoms = xcb_get_property_value(state);
+        int n = xcb_get_property_value_length(state) / 4;
+        for (int i = 0; i < n; ++i)
+        {
+            if (atoms[i] == wm->atom.net_wm_state_fullscreen)
+                c->fullscreen = 1;
+            else if (atoms[i] != wm->atom.net_wm_state_hidden &&
+                     c->net_state_count < CLIENT_NET_STATE_MAX)
+                c->net_state[c->net_state_count++] = atoms[i];
+        }
+    }
+    free(state);
+
+    // routed straight to a hidden workspace, never mapped until shown
+    if (!monitor_ws_visible(wm, ws)) ewmh_set_client_state(wm, c);
+    client_sync_init(wm, c);
+    client_title_request(wm, c);
 
     // fprintf(stderr, "client added: 0x%x (ws %d)\n", win, c->workspace);
     return c;
@@ -26,12 +241,34 @@ client_t *client_init(struct qwm_t *wm, xcb_window_t win)
 
 void client_kill(struct qwm_t *wm, client_t *c)
 {
-    (void)wm;
     if (!c) return;
+    ewmh_client_remove(wm, c);
+    place_remove(wm, c);
+    drag_forget(wm, c);
+    wm->managed_count--;
+    if (c->mapped) wm->mapped_count--;
+    if (c->sync_alarm) xcb_sync_destroy_alarm(wm->conn, c->sync_alarm);
+    if (c->title_inflight)
+    {
+        xcb_discard_reply(wm->conn, c->net_name_ck.sequence);
+        xcb_discard_reply(wm->conn, c->name_ck.sequence);
+    }
     // fprintf(stderr, "client removed: 0x%x (ws %d)\n", c->win, c->workspace);
     free(c);
 }
 
+client_t *client_find(struct qwm_t *wm, xcb_window_t win)
+{
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+        {
+            if (c->win == win) return c;
+        }
+    }
+    return NULL;
+}
+
 /*
 // NOTE: this for window decoration - but it seems unstable
 void client_add_overlay(struct qwm_t *wm, client_t *c)
@@ -75,21 +312,173 @@ void client_configure(struct qwm_t *wm, client_t *c, uint32_t x, uint32_t y,
     c->w = w;
     c->h = h;
 
-    uint32_t values[] = {x, y, w, h};
+    // still painting the previous size, only the latest geometry is kept
+    if (c->sync_waiting)
+    {
+        c->sync_pending = 1;
+        return;
+    }
 
-    uint16_t mask = XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y |
-                    XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT;
+    client_send_configure(wm, c);
+}
 
-    xcb_configure_window(wm->conn, c->win, mask, values);
+void client_show(struct qwm_t *wm, client_t *c, int32_t show)
+{
+    if (!c || c->mapped == !!show) return;
+
+    c->mapped = !!show;
+    wm->mapped_count += show ? 1 : -1;
+
+    // set before mapping so the client sees the new state on MapNotify,
+    // hidden clients are what toolkits throttle to background rates
+    ewmh_set_client_state(wm, c);
+
+    if (show)
+        xcb_map_window(wm->conn, c->win);
+    else
+        xcb_unmap_window(wm->conn, c->win);
 }
 
 void client_set_focus(struct qwm_t *wm, client_t *c, int32_t focused)
 {
     uint32_t v[2];
 
-    v[0] = focused ? BORDER_WIDTH : 0;
+    v[0] = focused && !c->fullscreen ? BORDER_WIDTH : 0;
     xcb_configure_window(wm->conn, c->win, XCB_CONFIG_WINDOW_BORDER_WIDTH, v);
 
-    v[0] = focused ? BORDER_FOCUS : BORDER_UNFOCUS;
+    v[0] = focused ? wm->rc.border_focus : wm->rc.border_unfocus;
     xcb_change_window_attributes(wm->conn, c->win, XCB_CW_BORDER_PIXEL, v);
+
+    if (focused && c->workspace == wm->current_ws)
+        ewmh_set_active(wm, c->win);
+}
+
+void client_set_fullscreen(struct qwm_t *wm, client_t *c, int32_t on)
+{
+    if (!c || c->fullscreen == !!on) return;
+
+    c->fullscreen = !!on;
+    ewmh_set_client_state(wm, c);
+
+    // border goes away, comes back only if still focused
+    client_set_focus(wm, c, wm->workspaces[c->workspace].focused == c);
+
+    if (on)
+    {
+        uint32_t v[] = {XCB_STACK_MODE_ABOVE};
+        xcb_configure_window(wm->conn, c->win, XCB_CONFIG_WINDOW_STACK_MODE,
+                             v);
+    }
+}
+
+void client_sync_notify(struct qwm_t *wm, xcb_sync_alarm_notify_event_t *ev)
+{
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+        {
+            if (c->sync_alarm != ev->alarm) continue;
+
+            c->sync_waiting = 0;
+            if (c->sync_pending)
+            {
+                c->sync_pending = 0;
+                client_send_configure(wm, c);
+            }
+            return;
+        }
+    }
+}
+
+void client_sync_expire(struct qwm_t *wm)
+{
+    uint64_t now = 0;
+
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+        {
+            if (!c->sync_waiting) continue;
+            if (!now) now = monotonic_ms();
+            if (now - c->sync_since_ms < SYNC_TIMEOUT_MS) continue;
+
+            c->sync_waiting = 0;
+            if (c->sync_pending)
+            {
+                c->sync_pending = 0;
+                client_send_configure(wm, c);
+            }
+        }
+    }
+}
+
+int client_sync_timeout(struct qwm_t *wm, int timeout)
+{
+    uint64_t now = 0;
+
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+        {
+            if (!c->sync_waiting) continue;
+            if (!now) now = monotonic_ms();
+
+            uint64_t due = c->sync_since_ms + SYNC_TIMEOUT_MS;
+            int left = due > now ? (int)(due - now) : 0;
+            if (timeout < 0 || left < timeout) timeout = left;
+        }
+    }
+    return timeout;
+}
+
+void client_title_stale(struct qwm_t *wm, client_t *c)
+{
+    (void)wm;
+    if (c->title_stale) return;
+
+    c->title_stale = 1;
+    c->title_since_ms = monotonic_ms();
+}
+
+int32_t client_title_poll(struct qwm_t *wm)
+{
+    uint64_t now = 0;
+    int32_t dirty = 0;
+
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+        {
+            if (c->title_inflight && client_title_take(wm, c) &&
+                monitor_ws_visible(wm, ws))
+                dirty = 1;
+
+            if (!c->title_stale || c->title_inflight) continue;
+            if (!now) now = monotonic_ms();
+            if (now - c->title_since_ms < TITLE_DEBOUNCE_MS) continue;
+
+            c->title_stale = 0;
+            client_title_request(wm, c);
+        }
+    }
+    return dirty;
+}
+
+int client_title_timeout(struct qwm_t *wm, int timeout)
+{
+    uint64_t now = 0;
+
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+        {
+            if (!c->title_stale || c->title_inflight) continue;
+            if (!now) now = monotonic_ms();
+
+            uint64_t due = c->title_since_ms + TITLE_DEBOUNCE_MS;
+            int left = due > now ? (int)(due - now) : 0;
+            if (left < timeout) timeout = left;
+        }
+    }
+    return timeout;
 }
@@ -2,26 +2,86 @@
 #define CLIENT_H
 
 #include <xcb/xcb.h>
+#include <xcb/sync.h>
 
 struct qwm_t;
 
+#define CLIENT_NET_STATE_MAX 8
+
 typedef struct client_t {
     xcb_window_t win;
     uint32_t x, y, w, h;
     uint16_t workspace;
+    uint8_t mapped; // as last requested by us, see client_show
+    uint8_t fullscreen;
+    uint8_t floating; // floats even on tile/monocle workspaces
+    // _NET_WM_STATE atoms we don't manage (ABOVE, STICKY, ...), written
+    // back next to HIDDEN and FULLSCREEN so our updates don't drop them
+    xcb_atom_t net_state[CLIENT_NET_STATE_MAX];
+    uint8_t net_state_count;
     struct client_t *next;
+
+    // floating geometry, size starts out as the client asked for
+    uint32_t fx, fy, fw, fh;
+    // cells held in the place_t grid of workspace place_ws
+    uint16_t place_ws;
+    uint16_t cell_x, cell_y, cell_w, cell_h;
+    uint8_t placed;
+
+    // _NET_WM_SYNC_REQUEST, counter is 0 when the client doesn't support it
+    xcb_sync_counter_t sync_counter;
+    xcb_sync_alarm_t sync_alarm;
+    uint64_t sync_value;
+    uint64_t sync_since_ms;
+    uint32_t sent_w, sent_h;
+    uint8_t sync_waiting;
+    uint8_t sync_pending;
+
+    // _NET_WM_NAME, else WM_NAME, for the taskbar
+    char title[64];
+    uint8_t title_len;
+    uint32_t title_gen; // bumped when title changes
+    xcb_get_property_cookie_t net_name_ck, name_ck;
+    uint8_t title_inflight; // both requests sent, replies not taken yet
+    uint8_t title_stale;    // PropertyNotify seen, refetch is debounced
+    uint64_t title_since_ms;
 } client_t;
 
-client_t *client_init(struct qwm_t *wm, xcb_window_t win);
+client_t *client_init(struct qwm_t *wm, xcb_window_t win, uint16_t ws);
 
 void client_kill(struct qwm_t *wm, client_t *c);
 
+client_t *client_find(struct qwm_t *wm, xcb_window_t win);
+
 void client_configure(struct qwm_t *wm, client_t *c, uint32_t x, uint32_t y,
                       uint32_t w, uint32_t h);
 
 // NOTE: this for window decoration - but it seems unstable
 // void client_add_overlay(struct qwm_t *wm, client_t *c);
 
+// map or unmap, only sending a request when the state changes
+void client_show(struct qwm_t *wm, client_t *c, int32_t show);
+
 void client_set_focus(struct qwm_t *wm, client_t *c, int32_t focused);
 
+// caller relayouts, the layout gives fullscreen clients the whole output
+void client_set_fullscreen(struct qwm_t *wm, client_t *c, int32_t on);
+
+void client_sync_notify(struct qwm_t *wm, xcb_sync_alarm_notify_event_t *ev);
+
+void client_sync_expire(struct qwm_t *wm);
+
+// poll timeout capped to the nearest sync wait running out, -1 is forever
+int client_sync_timeout(struct qwm_t *wm, int timeout);
+
+// PropertyNotify for _NET_WM_NAME or WM_NAME
+void client_title_stale(struct qwm_t *wm, client_t *c);
+
+// takes arrived title replies and sends debounced refetches, returns 1
+// when a title on a visible workspace changed
+int32_t client_title_poll(struct qwm_t *wm);
+
+// poll timeout capped to the next debounced refetch
+int client_title_timeout(struct qwm_t *wm, int timeout);
+
 #endif // CLIENT_H
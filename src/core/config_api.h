@@ -17,6 +17,23 @@ typedef struct {
     void (*func)(struct qwm_t *);
 } keybind_t;
 
+// window rules, matched at map time, first match wins
+typedef struct {
+    const char *class;    // WM_CLASS class, NULL matches any
+    const char *instance; // WM_CLASS instance, NULL matches any
+    const char *title;    // substring of the title, NULL matches any
+    uint8_t workspace;    // 1-5 on the focused output, 0 keeps current
+    uint8_t floating;
+    uint8_t focus; // take focus when mapped
+} rule_t;
+
+// apps kept started in the background, see pool.h
+typedef struct {
+    const char *class; // WM_CLASS class of its windows, unique to the pool
+    const char *cmd;   // run with /bin/sh -c
+    uint8_t count;     // instances kept parked
+} pool_app_t;
+
 extern void spawn(const char *program, ...);
 
 void quit_wm(struct qwm_t *qwm);
@@ -40,6 +57,13 @@ void focus_next(struct qwm_t *qwm);
 void focus_prev(struct qwm_t *qwm);
 void swap_master(struct qwm_t *wm);
 
+void focus_next_monitor(struct qwm_t *qwm);
+void move_to_next_monitor(struct qwm_t *qwm);
+
 void spawn_launcher(struct qwm_t *qwm);
 
+// maps a parked instance of my_pool[app] and starts its replacement
+void pool_claim(struct qwm_t *qwm, uint32_t app);
+void toggle_scratchpad(struct qwm_t *qwm);
+
 #endif // CONFIG_API_H
@@ -0,0 +1,162 @@
+#include "qwm.h"
+#include "drag.h"
+#include "util.h"
+
+#define BW BORDER_WIDTH
+
+#define IDLE_TIMEOUT_MS 1000
+
+static void drag_apply(struct qwm_t *wm, drag_t *d)
+{
+    client_t *c = d->c;
+    monitor_t *m = monitor_of_ws(wm, c->workspace);
+
+    int32_t dx = d->ptr_x - d->start_x;
+    int32_t dy = d->ptr_y - d->start_y;
+
+    int32_t x = (int32_t)d->orig_x;
+    int32_t y = (int32_t)d->orig_y;
+    int32_t w = (int32_t)d->orig_w;
+    int32_t h = (int32_t)d->orig_h;
+
+    if (d->mode == DRAG_MOVE)
+    {
+        x += dx;
+        y += dy;
+    }
+    else
+    {
+        w += dx;
+        h += dy;
+    }
+
+    // same bounds layout_floating would clamp to later
+    int32_t area_w = m->w;
+    int32_t area_h = m->h - m->taskbar.height;
+
+    if (w < MIN_W) w = MIN_W;
+    if (h < MIN_H) h = MIN_H;
+    if (w > area_w - 2 * BW) w = area_w - 2 * BW;
+    if (h > area_h - 2 * BW) h = area_h - 2 * BW;
+
+    if (x + w + 2 * BW > m->x + area_w) x = m->x + area_w - w - 2 * BW;
+    if (y + h + 2 * BW > m->y + area_h) y = m->y + area_h - h - 2 * BW;
+    if (x < m->x) x = m->x;
+    if (y < m->y) y = m->y;
+
+    c->fx = (uint32_t)x;
+    c->fy = (uint32_t)y;
+    c->fw = (uint32_t)w;
+    c->fh = (uint32_t)h;
+
+    client_configure(wm, c, c->fx, c->fy, c->fw, c->fh);
+
+    d->pending = 0;
+    d->last_ms = monotonic_ms();
+}
+
+/*****************************
+ * DRAG
+ *****************************/
+
+void drag_init(struct qwm_t *wm)
+{
+    static const uint16_t lock_masks[] = {0, XCB_MOD_MASK_LOCK, XCB_MOD_MASK_2,
+                                          XCB_MOD_MASK_LOCK | XCB_MOD_MASK_2};
+    static const uint8_t buttons[] = {DRAG_MOVE_BUTTON, DRAG_RESIZE_BUTTON};
+
+    for (uint32_t b = 0; b < sizeof(buttons); ++b)
+    {
+        for (uint32_t l = 0; l < 4; ++l)
+        {
+            xcb_grab_button(wm->conn, 0, wm->root,
+                            XCB_EVENT_MASK_BUTTON_PRESS |
+                                XCB_EVENT_MASK_BUTTON_RELEASE |
+                                XCB_EVENT_MASK_POINTER_MOTION,
+                            XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC,
+                            XCB_NONE, XCB_NONE, buttons[b],
+                            DRAG_MODIFIER | lock_masks[l]);
+        }
+    }
+}
+
+void drag_start(struct qwm_t *wm, xcb_button_press_event_t *ev)
+{
+    drag_t *d = &wm->drag;
+    if (d->c) return;
+
+    client_t *c = client_find(wm, ev->child);
+    if (!c || c->fullscreen || !monitor_ws_visible(wm, c->workspace))
+        return;
+    if (!c->floating && wm->workspaces[c->workspace].type != LAYOUT_FLOAT)
+        return;
+
+    monitor_t *m = monitor_of_ws(wm, c->workspace);
+
+    d->c = c;
+    d->mode = ev->detail == DRAG_MOVE_BUTTON ? DRAG_MOVE : DRAG_RESIZE;
+    d->start_x = d->ptr_x = ev->root_x;
+    d->start_y = d->ptr_y = ev->root_y;
+    d->orig_x = c->fx;
+    d->orig_y = c->fy;
+    d->orig_w = c->fw;
+    d->orig_h = c->fh;
+    d->pending = 0;
+    d->last_ms = 0;
+    d->interval_ms = 1000 / (m->refresh_hz ? m->refresh_hz : 60);
+
+    uint32_t v[] = {XCB_STACK_MODE_ABOVE};
+    xcb_configure_window(wm->conn, c->win, XCB_CONFIG_WINDOW_STACK_MODE, v);
+}
+
+void drag_motion(struct qwm_t *wm, xcb_motion_notify_event_t *ev)
+{
+    drag_t *d = &wm->drag;
+    if (!d->c) return;
+
+    d->ptr_x = ev->root_x;
+    d->ptr_y = ev->root_y;
+    d->pending = 1;
+}
+
+void drag_end(struct qwm_t *wm, xcb_button_release_event_t *ev)
+{
+    drag_t *d = &wm->drag;
+    if (!d->c) return;
+
+    d->ptr_x = ev->root_x;
+    d->ptr_y = ev->root_y;
+    drag_apply(wm, d);
+
+    // the final rect goes back into the placement grid
+    place_update(wm, d->c);
+
+    d->c = NULL;
+    d->mode = DRAG_NONE;
+}
+
+void drag_flush(struct qwm_t *wm)
+{
+    drag_t *d = &wm->drag;
+    if (!d->c || !d->pending) return;
+    if (monotonic_ms() - d->last_ms < d->interval_ms) return;
+
+    drag_apply(wm, d);
+}
+
+int drag_timeout(struct qwm_t *wm)
+{
+    drag_t *d = &wm->drag;
+    if (!d->c || !d->pending) return IDLE_TIMEOUT_MS;
+
+    uint64_t since = monotonic_ms() - d->last_ms;
+    return since >= d->interval_ms ? 0 : (int)(d->interval_ms - since);
+}
+
+void drag_forget(struct qwm_t *wm, client_t *c)
+{
+    if (wm->drag.c != c) return;
+
+    wm->drag.c = NULL;
+    wm->drag.mode = DRAG_NONE;
+}
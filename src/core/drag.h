@@ -0,0 +1,52 @@
+/*
+ * Mouse move/resize for floating workspaces
+ * DRAG_MODIFIER + DRAG_MOVE_BUTTON moves, + DRAG_RESIZE_BUTTON resizes.
+ *
+ * Motion events only record the pointer position. drag_flush runs once
+ * per drained event batch and sends at most one configure per frame of
+ * the output the window is on.
+ */
+
+#ifndef DRAG_H
+#define DRAG_H
+
+#include "client.h"
+
+struct qwm_t;
+
+typedef enum {
+    DRAG_NONE,
+    DRAG_MOVE,
+    DRAG_RESIZE,
+} drag_mode_t;
+
+typedef struct {
+    client_t *c;
+    drag_mode_t mode;
+
+    int16_t start_x, start_y; // pointer at press
+    uint32_t orig_x, orig_y, orig_w, orig_h;
+
+    int16_t ptr_x, ptr_y; // latest motion, not applied yet
+    uint8_t pending;
+
+    uint64_t last_ms;
+    uint32_t interval_ms; // one refresh of the output under the window
+} drag_t;
+
+void drag_init(struct qwm_t *wm);
+
+void drag_start(struct qwm_t *wm, xcb_button_press_event_t *ev);
+
+void drag_motion(struct qwm_t *wm, xcb_motion_notify_event_t *ev);
+
+void drag_end(struct qwm_t *wm, xcb_button_release_event_t *ev);
+
+void drag_flush(struct qwm_t *wm);
+
+// poll timeout in ms, short while a motion is waiting for its frame
+int drag_timeout(struct qwm_t *wm);
+
+void drag_forget(struct qwm_t *wm, client_t *c);
+
+#endif // DRAG_H
@@ -0,0 +1,142 @@
+#include "qwm.h"
+#include "ewmh.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void ewmh_init(struct qwm_t *wm, ewmh_t *e)
+{
+    memset(e, 0, sizeof(*e));
+
+    ewmh_set_desktop_count(wm, WORKSPACE_COUNT);
+
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, wm->root,
+                        wm->atom.net_client_list, XCB_ATOM_WINDOW, 32, 0,
+                        NULL);
+
+    e->active = XCB_NONE;
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, wm->root,
+                        wm->atom.net_active_window, XCB_ATOM_WINDOW, 32, 1,
+                        &e->active);
+
+    ewmh_set_current_desktop(wm);
+}
+
+void ewmh_kill(ewmh_t *e)
+{
+    free(e->clients);
+    e->clients = NULL;
+    e->count = 0;
+    e->cap = 0;
+}
+
+void ewmh_client_add(struct qwm_t *wm, client_t *c)
+{
+    ewmh_t *e = &wm->ewmh;
+
+    if (e->count == e->cap)
+    {
+        uint32_t new_cap = e->cap ? e->cap * 2 : 64;
+        xcb_window_t *n = realloc(e->clients, new_cap * sizeof(*n));
+        if (!n) return;
+
+        e->clients = n;
+        e->cap = new_cap;
+    }
+    e->clients[e->count++] = c->win;
+
+    // a pending rewrite will pick this one up anyway
+    if (!e->list_dirty)
+    {
+        xcb_change_property(wm->conn, XCB_PROP_MODE_APPEND, wm->root,
+                            wm->atom.net_client_list, XCB_ATOM_WINDOW, 32, 1,
+                            &c->win);
+    }
+
+    ewmh_set_client_desktop(wm, c);
+}
+
+void ewmh_client_remove(struct qwm_t *wm, client_t *c)
+{
+    ewmh_t *e = &wm->ewmh;
+
+    for (uint32_t i = 0; i < e->count; ++i)
+    {
+        if (e->clients[i] != c->win) continue;
+
+        memmove(&e->clients[i], &e->clients[i + 1],
+                (e->count - i - 1) * sizeof(*e->clients));
+        e->count--;
+        e->list_dirty = 1;
+        break;
+    }
+
+    if (e->active == c->win) ewmh_set_active(wm, XCB_NONE);
+}
+
+void ewmh_set_client_desktop(struct qwm_t *wm, client_t *c)
+{
+    uint32_t desktop = c->workspace;
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, c->win,
+                        wm->atom.net_wm_desktop, XCB_ATOM_CARDINAL, 32, 1,
+                        &desktop);
+}
+
+void ewmh_set_current_desktop(struct qwm_t *wm)
+{
+    uint32_t desktop = wm->current_ws;
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, wm->root,
+                        wm->atom.net_current_desktop, XCB_ATOM_CARDINAL, 32,
+                        1, &desktop);
+}
+
+void ewmh_set_desktop_count(struct qwm_t *wm, uint32_t count)
+{
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, wm->root,
+                        wm->atom.net_number_of_desktops, XCB_ATOM_CARDINAL,
+                        32, 1, &count);
+}
+
+void ewmh_set_active(struct qwm_t *wm, xcb_window_t win)
+{
+    ewmh_t *e = &wm->ewmh;
+    if (e->active == win) return;
+
+    e->active = win;
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, wm->root,
+                        wm->atom.net_active_window, XCB_ATOM_WINDOW, 32, 1,
+                        &win);
+}
+
+void ewmh_set_client_state(struct qwm_t *wm, client_t *c)
+{
+    // ICCCM WM_STATE: {state, icon window}
+    uint32_t wm_state[] = {c->mapped ? WM_STATE_NORMAL
+                                     : WM_STATE_ICONIC,
+                           XCB_NONE};
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, c->win,
+                        wm->atom.wm_state, wm->atom.wm_state, 32, 2,
+                        wm_state);
+
+    xcb_atom_t states[CLIENT_NET_STATE_MAX + 2];
+    uint32_t n = c->net_state_count;
+
+    memcpy(states, c->net_state, n * sizeof(xcb_atom_t));
+    if (!c->mapped) states[n++] = wm->atom.net_wm_state_hidden;
+    if (c->fullscreen) states[n++] = wm->atom.net_wm_state_fullscreen;
+
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, c->win,
+                        wm->atom.net_wm_state, XCB_ATOM_ATOM, 32, n, states);
+}
+
+void ewmh_commit(struct qwm_t *wm)
+{
+    ewmh_t *e = &wm->ewmh;
+    if (!e->list_dirty) return;
+
+    // removals are batched into one rewrite per event
+    xcb_change_property(wm->conn, XCB_PROP_MODE_REPLACE, wm->root,
+                        wm->atom.net_client_list, XCB_ATOM_WINDOW, 32,
+                        e->count, e->clients);
+    e->list_dirty = 0;
+}
@@ -0,0 +1,44 @@
+#ifndef EWMH_H
+#define EWMH_H
+
+#include "client.h"
+
+struct qwm_t;
+
+// ICCCM 4.1.3.1 WM_STATE values
+#define WM_STATE_NORMAL 1
+#define WM_STATE_ICONIC 3
+
+typedef struct {
+    // mirror of _NET_CLIENT_LIST, in mapping order
+    xcb_window_t *clients;
+    uint32_t count;
+    uint32_t cap;
+    uint8_t list_dirty;
+
+    xcb_window_t active;
+} ewmh_t;
+
+void ewmh_init(struct qwm_t *wm, ewmh_t *e);
+
+void ewmh_kill(ewmh_t *e);
+
+void ewmh_client_add(struct qwm_t *wm, client_t *c);
+
+void ewmh_client_remove(struct qwm_t *wm, client_t *c);
+
+void ewmh_set_client_desktop(struct qwm_t *wm, client_t *c);
+
+void ewmh_set_current_desktop(struct qwm_t *wm);
+
+void ewmh_set_desktop_count(struct qwm_t *wm, uint32_t count);
+
+void ewmh_set_active(struct qwm_t *wm, xcb_window_t win);
+
+// WM_STATE and _NET_WM_STATE from the client's mapped/fullscreen flags,
+// other _NET_WM_STATE atoms it had when managed are kept
+void ewmh_set_client_state(struct qwm_t *wm, client_t *c);
+
+void ewmh_commit(struct qwm_t *wm);
+
+#endif // EWMH_H
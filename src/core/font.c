@@ -0,0 +1,99 @@
+#include "qwm.h"
+#include "font.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int32_t try_open(xcb_connection_t *conn, xcb_font_t id,
+                        const char *name)
+{
+    xcb_void_cookie_t ck =
+        xcb_open_font_checked(conn, id, (uint16_t)strlen(name), name);
+    xcb_generic_error_t *err = xcb_request_check(conn, ck);
+    if (!err) return 1;
+
+    free(err);
+    return 0;
+}
+
+static void fill_widths(font_t *f, xcb_query_font_reply_t *q)
+{
+    xcb_charinfo_t *ci = xcb_query_font_char_infos(q);
+    int n = xcb_query_font_char_infos_length(q);
+
+    // 8 bit text is looked up with byte1 = 0
+    uint16_t lo = q->min_char_or_byte2, hi = q->max_char_or_byte2;
+    uint16_t fallback = q->max_bounds.character_width > 0
+                            ? (uint16_t)q->max_bounds.character_width
+                            : 0;
+
+    // glyphs outside the font draw as default_char
+    uint16_t def = fallback;
+    if (n > 0 && q->min_byte1 == 0 && q->default_char >= lo &&
+        q->default_char <= hi && q->default_char - lo < n)
+    {
+        int16_t w = ci[q->default_char - lo].character_width;
+        def = w > 0 ? (uint16_t)w : 0;
+    }
+
+    for (uint32_t c = 0; c < 256; ++c)
+    {
+        if (n == 0)
+        {
+            // no per-glyph info: every glyph has the max bounds
+            f->width[c] = fallback;
+        }
+        else if (q->min_byte1 == 0 && c >= lo && c <= hi &&
+                 (int)(c - lo) < n)
+        {
+            int16_t w = ci[c - lo].character_width;
+            f->width[c] = w > 0 ? (uint16_t)w : def;
+        }
+        else
+        {
+            f->width[c] = def;
+        }
+    }
+}
+
+/*****************************
+ * FONT
+ *****************************/
+
+void font_open(struct qwm_t *wm, font_t *f, const char *name)
+{
+    memset(f, 0, sizeof(*f));
+
+    f->id = xcb_generate_id(wm->conn);
+    if (!try_open(wm->conn, f->id, name))
+        xcb_open_font(wm->conn, f->id, 5, "fixed");
+
+    xcb_query_font_reply_t *q =
+        xcb_query_font_reply(wm->conn, xcb_query_font(wm->conn, f->id), NULL);
+    if (!q)
+    {
+        // keep text measurable, "fixed" is 6x13
+        for (uint32_t c = 0; c < 256; ++c) f->width[c] = 6;
+        f->ascent = 11;
+        f->descent = 2;
+        return;
+    }
+
+    f->ascent = q->font_ascent;
+    f->descent = q->font_descent;
+    fill_widths(f, q);
+    free(q);
+}
+
+void font_close(struct qwm_t *wm, font_t *f)
+{
+    if (f->id) xcb_close_font(wm->conn, f->id);
+    f->id = 0;
+}
+
+uint32_t font_text_width(const font_t *f, const char *s, uint32_t len)
+{
+    uint32_t w = 0;
+    for (uint32_t i = 0; i < len; ++i) w += f->width[(uint8_t)s[i]];
+    return w;
+}
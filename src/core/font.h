@@ -0,0 +1,28 @@
+/*
+ * Core font with a local width table
+ * Per-glyph metrics are fetched once with QueryFont, so measuring text is
+ * a table lookup per byte and never a round trip. Proportional fonts work
+ * the same as "fixed".
+ */
+
+#ifndef FONT_H
+#define FONT_H
+
+#include <xcb/xcb.h>
+
+struct qwm_t;
+
+typedef struct {
+    xcb_font_t id;
+    uint16_t width[256]; // advance of each byte, as drawn by *_text_8
+    int16_t ascent, descent;
+} font_t;
+
+// falls back to "fixed" when name can't be opened
+void font_open(struct qwm_t *wm, font_t *f, const char *name);
+
+void font_close(struct qwm_t *wm, font_t *f);
+
+uint32_t font_text_width(const font_t *f, const char *s, uint32_t len);
+
+#endif // FONT_H
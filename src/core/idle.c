@@ -0,0 +1,127 @@
+#include "qwm.h"
+#include "idle.h"
+
+#include <stdlib.h>
+#include <xcb/screensaver.h>
+#include <xcb/dpms.h>
+
+static void set_state(idle_t *i, uint8_t saver_on, uint8_t dpms_off)
+{
+    int32_t was = idle_paused(i);
+
+    i->saver_on = saver_on;
+    i->dpms_off = dpms_off;
+    if (was && !idle_paused(i)) i->woke = 1;
+}
+
+// standby and suspend count as off, the panel is dark either way
+static uint8_t dpms_query(struct qwm_t *wm)
+{
+    xcb_dpms_info_reply_t *r =
+        xcb_dpms_info_reply(wm->conn, xcb_dpms_info(wm->conn), NULL);
+    uint8_t off = r && r->state && r->power_level != XCB_DPMS_DPMS_MODE_ON;
+    free(r);
+    return off;
+}
+
+static uint8_t saver_active(uint8_t state)
+{
+    return state == XCB_SCREENSAVER_STATE_ON ||
+           state == XCB_SCREENSAVER_STATE_CYCLE;
+}
+
+/*****************************
+ * IDLE
+ *****************************/
+
+void idle_init(struct qwm_t *wm)
+{
+    idle_t *i = &wm->idle;
+    uint8_t saver_on = 0, dpms_off = 0;
+
+    const xcb_query_extension_reply_t *ext =
+        xcb_get_extension_data(wm->conn, &xcb_screensaver_id);
+    if (ext && ext->present)
+    {
+        i->saver_event_base = ext->first_event;
+        xcb_screensaver_select_input(wm->conn, wm->root,
+                                     XCB_SCREENSAVER_EVENT_NOTIFY_MASK);
+
+        xcb_screensaver_query_info_reply_t *r =
+            xcb_screensaver_query_info_reply(
+                wm->conn, xcb_screensaver_query_info(wm->conn, wm->root),
+                NULL);
+        if (r) saver_on = saver_active(r->state);
+        free(r);
+    }
+
+    ext = xcb_get_extension_data(wm->conn, &xcb_dpms_id);
+    if (ext && ext->present)
+    {
+        i->has_dpms = 1;
+        dpms_off = dpms_query(wm);
+
+#ifdef XCB_DPMS_INFO_NOTIFY
+        // InfoNotify is new in DPMS 1.2, headers and server both need it
+        xcb_dpms_get_version_reply_t *v = xcb_dpms_get_version_reply(
+            wm->conn, xcb_dpms_get_version(wm->conn, 1, 2), NULL);
+        if (v && (v->server_major_version > 1 ||
+                  v->server_minor_version >= 2))
+        {
+            i->dpms_opcode = ext->major_opcode;
+            xcb_dpms_select_input(wm->conn, XCB_DPMS_EVENT_MASK_INFO_NOTIFY);
+        }
+        free(v);
+#endif
+    }
+
+    set_state(i, saver_on, dpms_off);
+    i->woke = 0;
+}
+
+int32_t idle_event(struct qwm_t *wm, xcb_generic_event_t *ev)
+{
+    idle_t *i = &wm->idle;
+    uint8_t type = ev->response_type & ~0x80;
+
+    if (i->saver_event_base &&
+        type == i->saver_event_base + XCB_SCREENSAVER_NOTIFY)
+    {
+        xcb_screensaver_notify_event_t *sev =
+            (xcb_screensaver_notify_event_t *)ev;
+
+        // without InfoNotify this is our only chance to see DPMS change
+        uint8_t dpms_off = i->dpms_off;
+        if (i->has_dpms && !i->dpms_opcode) dpms_off = dpms_query(wm);
+
+        set_state(i, saver_active(sev->state), dpms_off);
+        return 1;
+    }
+
+#ifdef XCB_DPMS_INFO_NOTIFY
+    if (i->dpms_opcode && type == XCB_GE_GENERIC)
+    {
+        xcb_ge_generic_event_t *gev = (xcb_ge_generic_event_t *)ev;
+        if (gev->extension != i->dpms_opcode ||
+            gev->event_type != XCB_DPMS_INFO_NOTIFY)
+            return 0;
+
+        xcb_dpms_info_notify_event_t *dev =
+            (xcb_dpms_info_notify_event_t *)ev;
+        set_state(i, i->saver_on,
+                  dev->state && dev->power_level != XCB_DPMS_DPMS_MODE_ON);
+        return 1;
+    }
+#endif
+
+    return 0;
+}
+
+int32_t idle_paused(const idle_t *i) { return i->saver_on || i->dpms_off; }
+
+int32_t idle_woke(idle_t *i)
+{
+    int32_t woke = i->woke;
+    i->woke = 0;
+    return woke;
+}
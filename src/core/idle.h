@@ -0,0 +1,40 @@
+/*
+ * Display blank and idle tracking
+ * MIT-SCREEN-SAVER tells us when the server screensaver kicks in, DPMS 1.2
+ * InfoNotify when the monitor power level changes. While either one is on
+ * nobody can see the bars, so qwm_run stops drawing and polling the tray
+ * and sleeps in poll until the next X event. Leaving it flags one catch-up
+ * refresh, see idle_woke.
+ *
+ * Older servers without InfoNotify only get DPMS queried on screensaver
+ * changes. Without either extension we are simply never idle.
+ */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <xcb/xcb.h>
+
+struct qwm_t;
+
+typedef struct {
+    uint8_t saver_event_base; // 0 without MIT-SCREEN-SAVER
+    uint8_t dpms_opcode;      // 0 without DPMS InfoNotify
+    uint8_t has_dpms;
+    uint8_t saver_on;
+    uint8_t dpms_off;
+    uint8_t woke; // left idle since the last idle_woke
+} idle_t;
+
+void idle_init(struct qwm_t *wm);
+
+// returns 1 when ev was a screensaver or DPMS event
+int32_t idle_event(struct qwm_t *wm, xcb_generic_event_t *ev);
+
+// screen blanked or powered down, nothing on it needs updating
+int32_t idle_paused(const idle_t *i);
+
+// returns 1 once after leaving idle
+int32_t idle_woke(idle_t *i);
+
+#endif // IDLE_H
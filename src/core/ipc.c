@@ -0,0 +1,417 @@
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE // struct ucred
+#endif
+
+#include "qwm.h"
+#include "ipc.h"
+
+#if USE_IPC
+
+#    include <stdio.h>
+#    include <stdlib.h>
+#    include <string.h>
+
+#    include <fcntl.h>      // fcntl, O_NONBLOCK
+#    include <unistd.h>     // close, unlink, getuid
+#    include <sys/socket.h> // socket, bind, listen, accept, send, recv
+#    include <sys/stat.h>   // chmod, umask
+#    include <sys/un.h>     // sockaddr_un
+
+#    define IPC_BUF_SIZE 65536
+
+// clang-format off
+static void (*const ipc_cmds[])(struct qwm_t *) = {
+    [IPC_CMD_QUIT_WM] = quit_wm,
+    [IPC_CMD_QUIT_APPLICATION] = quit_application,
+    [IPC_CMD_WORKSPACE_1] = workspace_1,
+    [IPC_CMD_WORKSPACE_2] = workspace_2,
+    [IPC_CMD_WORKSPACE_3] = workspace_3,
+    [IPC_CMD_WORKSPACE_4] = workspace_4,
+    [IPC_CMD_WORKSPACE_5] = workspace_5,
+    [IPC_CMD_MOVE_TO_WORKSPACE_1] = move_to_workspace_1,
+    [IPC_CMD_MOVE_TO_WORKSPACE_2] = move_to_workspace_2,
+    [IPC_CMD_MOVE_TO_WORKSPACE_3] = move_to_workspace_3,
+    [IPC_CMD_MOVE_TO_WORKSPACE_4] = move_to_workspace_4,
+    [IPC_CMD_MOVE_TO_WORKSPACE_5] = move_to_workspace_5,
+    [IPC_CMD_TOGGLE_TILE_ORIENT] = toggle_tile_orient,
+    [IPC_CMD_TOGGLE_LAYOUT] = toggle_layout,
+    [IPC_CMD_FOCUS_NEXT] = focus_next,
+    [IPC_CMD_FOCUS_PREV] = focus_prev,
+    [IPC_CMD_SWAP_MASTER] = swap_master,
+    [IPC_CMD_SPAWN_LAUNCHER] = spawn_launcher,
+    [IPC_CMD_FOCUS_NEXT_MONITOR] = focus_next_monitor,
+    [IPC_CMD_MOVE_TO_NEXT_MONITOR] = move_to_next_monitor,
+    [IPC_CMD_TOGGLE_SCRATCHPAD] = toggle_scratchpad,
+};
+// clang-format on
+
+// single reply buffer, the event loop is single threaded
+static uint8_t ipc_buf[IPC_BUF_SIZE];
+
+static void peer_close(ipc_peer_t *p)
+{
+    if (p->fd >= 0) close(p->fd);
+    p->fd = -1;
+    p->events = 0;
+}
+
+static int32_t peer_send(ipc_peer_t *p, uint8_t type, uint8_t arg,
+                         const void *payload, uint16_t len)
+{
+    ipc_header_t h = {.type = type, .arg = arg, .len = len};
+
+    memcpy(ipc_buf, &h, sizeof(h));
+    if (payload && len && payload != ipc_buf + sizeof(h))
+        memcpy(ipc_buf + sizeof(h), payload, len);
+
+    ssize_t n = send(p->fd, ipc_buf, sizeof(h) + len,
+                     MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n < 0)
+    {
+        // never block the event loop on a slow reader
+        peer_close(p);
+        return -1;
+    }
+    return 0;
+}
+
+static void fill_state(struct qwm_t *qwm, ipc_state_t *st)
+{
+    workspace_t *w = &qwm->workspaces[qwm->current_ws];
+
+    memset(st, 0, sizeof(*st));
+    st->focused = w->focused ? w->focused->win : XCB_NONE;
+    st->workspace = (uint8_t)qwm->current_ws;
+    st->layout = (uint8_t)w->type;
+    st->vertical = w->vertical;
+}
+
+static uint16_t build_workspaces(struct qwm_t *qwm, uint8_t *out)
+{
+    ipc_workspace_t *iw = (ipc_workspace_t *)out;
+
+    for (uint16_t i = 0; i < WORKSPACE_TOTAL; ++i)
+    {
+        workspace_t *w = &qwm->workspaces[i];
+        uint16_t n = 0;
+        for (client_t *c = w->clients; c; c = c->next) n++;
+
+        iw[i].focused = w->focused ? w->focused->win : XCB_NONE;
+        iw[i].clients = n;
+        iw[i].layout = (uint8_t)w->type;
+        iw[i].vertical = w->vertical;
+    }
+
+    return (uint16_t)(WORKSPACE_TOTAL * sizeof(*iw));
+}
+
+static uint16_t build_clients(struct qwm_t *qwm, uint8_t ws, uint8_t *out)
+{
+    ipc_client_t *ic = (ipc_client_t *)out;
+    uint16_t max = (IPC_BUF_SIZE - sizeof(ipc_header_t)) / sizeof(*ic);
+    uint16_t n = 0;
+
+    for (uint16_t i = 0; i < WORKSPACE_TOTAL; ++i)
+    {
+        if (ws != 0xFF && ws != i) continue;
+
+        workspace_t *w = &qwm->workspaces[i];
+        for (client_t *c = w->clients; c && n < max; c = c->next, n++)
+        {
+            ic[n] = (ipc_client_t){
+                .win = c->win,
+                .x = (int16_t)c->x,
+                .y = (int16_t)c->y,
+                .w = (uint16_t)c->w,
+                .h = (uint16_t)c->h,
+                .workspace = (uint8_t)i,
+                .focused = (w->focused == c),
+                .mapped = c->mapped,
+            };
+        }
+    }
+
+    return (uint16_t)(n * sizeof(*ic));
+}
+
+static uint16_t build_layouts(struct qwm_t *qwm, uint8_t *out)
+{
+    ipc_layout_t *il = (ipc_layout_t *)out;
+
+    for (uint16_t i = 0; i < WORKSPACE_TOTAL; ++i)
+    {
+        il[i].layout = (uint8_t)qwm->workspaces[i].type;
+        il[i].vertical = qwm->workspaces[i].vertical;
+    }
+
+    return (uint16_t)(WORKSPACE_TOTAL * sizeof(*il));
+}
+
+static uint16_t build_tray(struct qwm_t *qwm, uint8_t *out)
+{
+    tray_status_t *ts = &qwm->tray;
+    ipc_tray_t t;
+
+    memset(&t, 0, sizeof(t));
+    t.uptime_min = ts->up.current;
+    t.mem_used_mb = ts->mems.current;
+    t.mem_total_mb = ts->mems.total;
+    t.cpu_mhz = ts->cpu.mhz;
+    t.bat_capacity = ts->bat.capacity;
+    t.bat_state = (uint8_t)ts->bat.state;
+    t.cn_state = (uint8_t)ts->connection.cn_state;
+    t.cn_type = (uint8_t)ts->connection.cn_type;
+    memcpy(t.governor, ts->gov.name, sizeof(t.governor));
+    memcpy(t.connection, ts->connection.name, sizeof(t.connection));
+
+    memcpy(out, &t, sizeof(t));
+    return (uint16_t)sizeof(t);
+}
+
+static uint16_t build_stats(struct qwm_t *qwm, uint8_t *out)
+{
+    ipc_stats_t st = {qwm->managed_count, qwm->mapped_count};
+
+    memcpy(out, &st, sizeof(st));
+    return (uint16_t)sizeof(st);
+}
+
+static void run_command(struct qwm_t *qwm, uint8_t cmd, const uint8_t *data,
+                        uint16_t len)
+{
+    if (cmd == IPC_CMD_SPAWN)
+    {
+        char line[256];
+        if (!len || len >= sizeof(line)) return;
+
+        memcpy(line, data, len);
+        line[len] = '\0';
+        spawn("/bin/sh", "-c", line, NULL);
+        return;
+    }
+
+    ipc_cmds[cmd](qwm);
+}
+
+// returns 1 when a command ran, the bars may show something else now
+static int32_t peer_request(struct qwm_t *qwm, ipc_peer_t *p)
+{
+    ssize_t n = recv(p->fd, ipc_buf, IPC_BUF_SIZE, MSG_DONTWAIT);
+    if (n <= 0)
+    {
+        peer_close(p);
+        return 0;
+    }
+    if ((size_t)n < sizeof(ipc_header_t)) return 0;
+
+    ipc_header_t h;
+    memcpy(&h, ipc_buf, sizeof(h));
+    if (sizeof(h) + h.len > (size_t)n)
+    {
+        peer_send(p, IPC_ERROR, h.type, NULL, 0);
+        return 0;
+    }
+
+    uint8_t *payload = ipc_buf + sizeof(h);
+    uint16_t len = 0;
+    int32_t changed = 0;
+
+    switch (h.type)
+    {
+    case IPC_QUERY_WORKSPACES:
+        len = build_workspaces(qwm, payload);
+        peer_send(p, h.type, (uint8_t)qwm->current_ws, payload, len);
+        break;
+    case IPC_QUERY_CLIENTS:
+        len = build_clients(qwm, h.arg, payload);
+        peer_send(p, h.type, h.arg, payload, len);
+        break;
+    case IPC_QUERY_LAYOUTS:
+        len = build_layouts(qwm, payload);
+        peer_send(p, h.type, 0, payload, len);
+        break;
+    case IPC_QUERY_TRAY:
+        len = build_tray(qwm, payload);
+        peer_send(p, h.type, 0, payload, len);
+        break;
+    case IPC_QUERY_STATS:
+        len = build_stats(qwm, payload);
+        peer_send(p, h.type, 0, payload, len);
+        break;
+    case IPC_COMMAND:
+        if (h.arg >= IPC_CMD_COUNT)
+        {
+            peer_send(p, IPC_ERROR, h.type, NULL, 0);
+            break;
+        }
+        // reply first, the command may be quit_wm
+        if (peer_send(p, h.type, h.arg, NULL, 0) < 0) break;
+        run_command(qwm, h.arg, payload, h.len);
+        ipc_notify(qwm);
+        xcb_flush(qwm->conn);
+        changed = 1;
+        break;
+    case IPC_SUBSCRIBE:
+        p->events = h.arg;
+        peer_send(p, h.type, h.arg, NULL, 0);
+        break;
+    default: peer_send(p, IPC_ERROR, h.type, NULL, 0); break;
+    }
+    return changed;
+}
+
+static void accept_peer(ipc_t *ipc)
+{
+    int fd = accept(ipc->fd, NULL, NULL);
+    if (fd < 0) return;
+
+    // commands drive the WM, only our own user gets to send them
+    struct ucred cred;
+    socklen_t cred_len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 ||
+        cred.uid != getuid())
+    {
+        close(fd);
+        return;
+    }
+
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    for (int32_t i = 0; i < IPC_MAX_CLIENTS; ++i)
+    {
+        if (ipc->peers[i].fd < 0)
+        {
+            ipc->peers[i].fd = fd;
+            ipc->peers[i].events = 0;
+            return;
+        }
+    }
+
+    close(fd);
+}
+
+/*****************************
+ * IPC
+ *****************************/
+
+void ipc_init(struct qwm_t *qwm)
+{
+    ipc_t *ipc = &qwm->ipc;
+
+    ipc->fd = -1;
+    for (int32_t i = 0; i < IPC_MAX_CLIENTS; ++i) ipc->peers[i].fd = -1;
+
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    if (dir && dir[0])
+        snprintf(ipc->path, sizeof(ipc->path), "%s/%s", dir,
+                 IPC_SOCKET_NAME);
+    else
+        snprintf(ipc->path, sizeof(ipc->path), "/tmp/qwm-%u.sock",
+                 (unsigned)getuid());
+
+    ipc->fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                     0);
+    if (ipc->fd < 0) return;
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", ipc->path);
+
+    // created 0600 right away, the /tmp fallback name is predictable
+    unlink(ipc->path);
+    mode_t mask = umask(077);
+    int bound = bind(ipc->fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(mask);
+
+    if (bound < 0 || listen(ipc->fd, IPC_MAX_CLIENTS) < 0)
+    {
+        close(ipc->fd);
+        ipc->fd = -1;
+        return;
+    }
+
+    chmod(ipc->path, 0600);
+    fill_state(qwm, &ipc->last);
+}
+
+void ipc_kill(struct qwm_t *qwm)
+{
+    ipc_t *ipc = &qwm->ipc;
+
+    for (int32_t i = 0; i < IPC_MAX_CLIENTS; ++i) peer_close(&ipc->peers[i]);
+
+    if (ipc->fd >= 0)
+    {
+        close(ipc->fd);
+        unlink(ipc->path);
+    }
+    ipc->fd = -1;
+}
+
+nfds_t ipc_pollfds(struct qwm_t *qwm, struct pollfd *pfd, nfds_t max)
+{
+    ipc_t *ipc = &qwm->ipc;
+    nfds_t n = 0;
+
+    if (ipc->fd < 0 || max == 0) return 0;
+
+    pfd[n++] = (struct pollfd){.fd = ipc->fd, .events = POLLIN};
+    for (int32_t i = 0; i < IPC_MAX_CLIENTS && n < max; ++i)
+    {
+        // slots stay positional so ipc_handle can map them back
+        pfd[n++] = (struct pollfd){.fd = ipc->peers[i].fd, .events = POLLIN};
+    }
+
+    return n;
+}
+
+int32_t ipc_handle(struct qwm_t *qwm, struct pollfd *pfd, nfds_t n)
+{
+    ipc_t *ipc = &qwm->ipc;
+    int32_t changed = 0;
+    if (n == 0) return 0;
+
+    for (nfds_t i = 1; i < n; ++i)
+    {
+        ipc_peer_t *p = &ipc->peers[i - 1];
+        if (p->fd < 0 || p->fd != pfd[i].fd) continue;
+
+        if (pfd[i].revents & POLLIN)
+            changed |= peer_request(qwm, p);
+        else if (pfd[i].revents & (POLLHUP | POLLERR))
+            peer_close(p);
+    }
+
+    if (pfd[0].revents & POLLIN) accept_peer(ipc);
+    return changed;
+}
+
+void ipc_notify(struct qwm_t *qwm)
+{
+    ipc_t *ipc = &qwm->ipc;
+    if (ipc->fd < 0) return;
+
+    ipc_state_t st;
+    fill_state(qwm, &st);
+
+    // only push what actually changed since the last event
+    uint8_t changed = 0;
+    if (st.workspace != ipc->last.workspace) changed |= IPC_EVENT_WORKSPACE;
+    if (st.focused != ipc->last.focused) changed |= IPC_EVENT_FOCUS;
+    if (st.layout != ipc->last.layout || st.vertical != ipc->last.vertical)
+        changed |= IPC_EVENT_LAYOUT;
+
+    if (!changed) return;
+
+    ipc->last = st;
+
+    for (int32_t i = 0; i < IPC_MAX_CLIENTS; ++i)
+    {
+        ipc_peer_t *p = &ipc->peers[i];
+        if (p->fd < 0 || !(p->events & changed)) continue;
+
+        peer_send(p, IPC_EVENT, changed & p->events, &st, sizeof(st));
+    }
+}
+
+#endif // USE_IPC
@@ -0,0 +1,183 @@
+/*
+ * IPC
+ * Optional binary protocol over a SOCK_SEQPACKET unix socket.
+ * Compiled out unless USE_IPC is set in config.h.
+ *
+ * Socket: $XDG_RUNTIME_DIR/qwm.sock, or /tmp/qwm-<uid>.sock
+ *
+ * Every packet is an ipc_header_t followed by `len` payload bytes, in
+ * host byte order. Requests get exactly one reply packet with the same
+ * type (or IPC_ERROR). After IPC_SUBSCRIBE the server also pushes
+ * IPC_EVENT packets for the subscribed mask; a subscriber that stops
+ * reading is dropped.
+ */
+
+#ifndef IPC_H
+#define IPC_H
+
+#include "../config.h" // IWYU pragma: keep
+
+#include <stdint.h>
+#include <poll.h>
+
+struct qwm_t;
+
+#define IPC_SOCKET_NAME "qwm.sock"
+
+typedef enum {
+    IPC_QUERY_WORKSPACES = 1, // arg: -            reply: ipc_workspace_t[]
+    IPC_QUERY_CLIENTS,        // arg: ws or 0xFF   reply: ipc_client_t[]
+    IPC_QUERY_LAYOUTS,        // arg: -            reply: ipc_layout_t[]
+    IPC_QUERY_TRAY,           // arg: -            reply: ipc_tray_t
+    IPC_COMMAND,              // arg: ipc_cmd_t    payload: see IPC_CMD_SPAWN
+    IPC_SUBSCRIBE,            // arg: event mask   reply: empty
+    IPC_QUERY_STATS,          // arg: -            reply: ipc_stats_t
+    IPC_ERROR = 0x7F,
+    IPC_EVENT = 0x80, // arg: event bit          payload: ipc_state_t
+} ipc_msg_t;
+
+typedef enum {
+    IPC_EVENT_WORKSPACE = 1 << 0,
+    IPC_EVENT_FOCUS = 1 << 1,
+    IPC_EVENT_LAYOUT = 1 << 2,
+} ipc_event_t;
+
+// same functions as config_api.h
+typedef enum {
+    IPC_CMD_QUIT_WM = 0,
+    IPC_CMD_QUIT_APPLICATION,
+    IPC_CMD_WORKSPACE_1,
+    IPC_CMD_WORKSPACE_2,
+    IPC_CMD_WORKSPACE_3,
+    IPC_CMD_WORKSPACE_4,
+    IPC_CMD_WORKSPACE_5,
+    IPC_CMD_MOVE_TO_WORKSPACE_1,
+    IPC_CMD_MOVE_TO_WORKSPACE_2,
+    IPC_CMD_MOVE_TO_WORKSPACE_3,
+    IPC_CMD_MOVE_TO_WORKSPACE_4,
+    IPC_CMD_MOVE_TO_WORKSPACE_5,
+    IPC_CMD_TOGGLE_TILE_ORIENT,
+    IPC_CMD_TOGGLE_LAYOUT,
+    IPC_CMD_FOCUS_NEXT,
+    IPC_CMD_FOCUS_PREV,
+    IPC_CMD_SWAP_MASTER,
+    IPC_CMD_SPAWN_LAUNCHER,
+    IPC_CMD_SPAWN, // payload: shell command line, not NUL terminated
+    IPC_CMD_FOCUS_NEXT_MONITOR,
+    IPC_CMD_MOVE_TO_NEXT_MONITOR,
+    IPC_CMD_TOGGLE_SCRATCHPAD,
+    IPC_CMD_COUNT,
+} ipc_cmd_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t arg;
+    uint16_t len;
+} ipc_header_t;
+
+typedef struct {
+    uint32_t focused;
+    uint16_t clients;
+    uint8_t layout;
+    uint8_t vertical;
+} ipc_workspace_t;
+
+typedef struct {
+    uint32_t win;
+    int16_t x, y;
+    uint16_t w, h;
+    uint8_t workspace;
+    uint8_t focused;
+    uint8_t mapped;
+    uint8_t pad;
+} ipc_client_t;
+
+typedef struct {
+    uint8_t layout;
+    uint8_t vertical;
+} ipc_layout_t;
+
+typedef struct {
+    uint64_t uptime_min;
+    uint32_t mem_used_mb;
+    uint32_t mem_total_mb;
+    int32_t cpu_mhz;
+    uint16_t bat_capacity;
+    uint8_t bat_state;
+    uint8_t cn_state;
+    uint8_t cn_type;
+    uint8_t pad[3];
+    char governor[16];
+    char connection[32];
+} ipc_tray_t;
+
+typedef struct {
+    uint32_t managed;
+    uint32_t mapped;
+} ipc_stats_t;
+
+// pushed with every event, arg tells which part changed
+typedef struct {
+    uint32_t focused;
+    uint8_t workspace;
+    uint8_t layout;
+    uint8_t vertical;
+    uint8_t pad;
+} ipc_state_t;
+
+#if USE_IPC
+
+#    define IPC_MAX_CLIENTS 8
+
+typedef struct {
+    int fd;
+    uint8_t events;
+} ipc_peer_t;
+
+typedef struct {
+    int fd;
+    char path[108];
+    ipc_peer_t peers[IPC_MAX_CLIENTS];
+    ipc_state_t last;
+} ipc_t;
+
+void ipc_init(struct qwm_t *qwm);
+
+void ipc_kill(struct qwm_t *qwm);
+
+nfds_t ipc_pollfds(struct qwm_t *qwm, struct pollfd *pfd, nfds_t max);
+
+// returns 1 when a command ran and the bars need a redraw
+int32_t ipc_handle(struct qwm_t *qwm, struct pollfd *pfd, nfds_t n);
+
+void ipc_notify(struct qwm_t *qwm);
+
+#else
+
+static inline void ipc_init(struct qwm_t *qwm) { (void)qwm; }
+
+static inline void ipc_kill(struct qwm_t *qwm) { (void)qwm; }
+
+static inline nfds_t ipc_pollfds(struct qwm_t *qwm, struct pollfd *pfd,
+                                 nfds_t max)
+{
+    (void)qwm;
+    (void)pfd;
+    (void)max;
+    return 0;
+}
+
+static inline int32_t ipc_handle(struct qwm_t *qwm, struct pollfd *pfd,
+                                 nfds_t n)
+{
+    (void)qwm;
+    (void)pfd;
+    (void)n;
+    return 0;
+}
+
+static inline void ipc_notify(struct qwm_t *qwm) { (void)qwm; }
+
+#endif // USE_IPC
+
+#endif // IPC_H
@@ -20,6 +20,8 @@
 
 #define KEY_MINUS 20
 #define KEY_EQUAL 21
+#define KEY_COMMA 59
+#define KEY_PERIOD 60
 
 #define KEY_A 38
 #define KEY_B 56
@@ -10,7 +10,7 @@
 #include <dirent.h>   // DIR, dirent, opendir, closedir
 #include <sys/stat.h> // stat, S_ISREG
 
-#define LINE_HEIGHT 16
+#define LINE_GAP 3 // between rows, "fixed" ends up at the old 16px pitch
 #define PADDING 4
 #define MAX_DRAW 8
 
@@ -57,12 +57,24 @@ static int32_t is_banned(const char *name)
     return 0;
 }
 
+// row pitch follows the configured font, so taller fonts don't overlap
+static int32_t line_height(const qwm_t *qwm)
+{
+    return qwm->font.ascent + qwm->font.descent + LINE_GAP;
+}
+
+// row 0 is the input line, matches start at row 1
+static int32_t row_top(const qwm_t *qwm, uint32_t row)
+{
+    return PADDING + (int32_t)row * line_height(qwm);
+}
+
 static void launcher_resize(qwm_t *qwm, launcher_t *l)
 {
     uint32_t lines = 1 + l->match_count;
     if (lines > 1 + MAX_DRAW) lines = 1 + MAX_DRAW;
 
-    l->h = (int16_t)(lines * LINE_HEIGHT + PADDING * 2);
+    l->h = (int16_t)(lines * line_height(qwm) + PADDING * 2);
 
     uint32_t values[] = {(uint32_t)l->h};
     xcb_configure_window(qwm->conn, l->win, XCB_CONFIG_WINDOW_HEIGHT, values);
@@ -220,13 +232,14 @@ void launcher_open(struct qwm_t *qwm, launcher_t *l)
     l->match_count = 0;
 
     l->w = LAUNCHER_WIDTH;
-    l->h = 24;
-    l->x = (qwm->w - l->w) / 2;
-    l->y = LAUNCHER_POSITION_Y;
+    l->h = (int16_t)(line_height(qwm) + PADDING * 2);
+    monitor_t *m = &qwm->monitors[qwm->current_mon];
+    l->x = (int16_t)(m->x + (m->w - l->w) / 2);
+    l->y = (int16_t)(m->y + LAUNCHER_POSITION_Y);
 
     // clang-format off
     uint32_t mask = XCB_CW_BACK_PIXEL | XCB_CW_OVERRIDE_REDIRECT | XCB_CW_EVENT_MASK;
-    uint32_t values[3] = {LAUNCHER_BG_COLOR, 1, XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_EXPOSURE};
+    uint32_t values[3] = {qwm->rc.launcher_bg_color, 1, XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_EXPOSURE};
 
     l->win = xcb_generate_id(qwm->conn);
     xcb_create_window(qwm->conn, XCB_COPY_FROM_PARENT, l->win, qwm->root,
@@ -247,14 +260,16 @@ void launcher_open(struct qwm_t *qwm, launcher_t *l)
                         XCB_CURRENT_TIME);
 
     l->sel_text_gc = xcb_generate_id(qwm->conn);
-    uint32_t bg_values[] = {LAUNCHER_FG_COLOR};
+    uint32_t bg_values[] = {qwm->rc.launcher_fg_color};
     xcb_create_gc(qwm->conn, l->sel_text_gc, l->win, XCB_GC_FOREGROUND,
                   bg_values);
 
     l->text_gc = xcb_generate_id(qwm->conn);
-    uint32_t text_values[] = {LAUNCHER_FONT_COLOR, LAUNCHER_FG_COLOR};
+    uint32_t text_values[] = {qwm->rc.launcher_font_color,
+                             qwm->rc.launcher_fg_color, qwm->font.id};
     xcb_create_gc(qwm->conn, l->text_gc, l->win,
-                  XCB_GC_FOREGROUND | XCB_GC_BACKGROUND, text_values);
+                  XCB_GC_FOREGROUND | XCB_GC_BACKGROUND | XCB_GC_FONT,
+                  text_values);
 
     xcb_flush(qwm->conn);
     l->opened = 1;
@@ -281,10 +296,12 @@ void launcher_draw(struct qwm_t *qwm, launcher_t *l)
 
     xcb_clear_area(qwm->conn, 0, l->win, 0, 0, (uint16_t)l->w, (uint16_t)l->h);
 
-    int y = PADDING + LINE_HEIGHT;
+    int32_t lh = line_height(qwm);
+    int32_t above = qwm->font.ascent + LINE_GAP / 2; // row top to baseline
 
-    xcb_image_text_8(qwm->conn, (uint8_t)strlen(l->input), l->win,
-                     qwm->taskbar.gc, 8, 16, l->input);
+    xcb_gcontext_t font_gc = qwm->monitors[qwm->current_mon].taskbar.gc;
+    xcb_image_text_8(qwm->conn, (uint8_t)strlen(l->input), l->win, font_gc, 8,
+                     (int16_t)(row_top(qwm, 0) + above), l->input);
 
     // draw matches below
     uint32_t draw_count = l->match_count;
@@ -295,21 +312,21 @@ void launcher_draw(struct qwm_t *qwm, launcher_t *l)
         uint16_t idx = l->match_indices[i];
         const char *name = l->cmds[idx].name;
 
-        y += LINE_HEIGHT;
+        int32_t top = row_top(qwm, i + 1);
         if (i == l->sel)
         {
             xcb_rectangle_t r = {.x = 0,
-                                 .y = (int16_t)(y - LINE_HEIGHT + 4),
+                                 .y = (int16_t)top,
                                  .width = (uint16_t)l->w,
-                                 .height = (uint16_t)LINE_HEIGHT};
+                                 .height = (uint16_t)lh};
 
             xcb_poly_fill_rectangle(qwm->conn, l->win, l->sel_text_gc, 1, &r);
         }
 
-        xcb_gcontext_t gc = (i == l->sel) ? l->text_gc : qwm->taskbar.gc;
+        xcb_gcontext_t gc = (i == l->sel) ? l->text_gc : font_gc;
 
         xcb_image_text_8(qwm->conn, (uint8_t)strlen(name), l->win, gc, PADDING,
-                         (int16_t)y, name);
+                         (int16_t)(top + above), name);
     }
 
     xcb_flush(qwm->conn);
@@ -0,0 +1,385 @@
+#include "qwm.h"
+#include "monitor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CRTCS 16
+#define DEFAULT_HZ 60
+
+typedef struct {
+    xcb_randr_crtc_t crtc;
+    int16_t x, y;
+    uint16_t w, h;
+    uint16_t hz;
+} output_rect_t;
+
+static uint16_t
+mode_refresh(xcb_randr_get_screen_resources_current_reply_t *res,
+             xcb_randr_mode_t mode)
+{
+    xcb_randr_mode_info_t *modes =
+        xcb_randr_get_screen_resources_current_modes(res);
+    int n = xcb_randr_get_screen_resources_current_modes_length(res);
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (modes[i].id != mode) continue;
+        if (!modes[i].htotal || !modes[i].vtotal) break;
+
+        uint64_t frame = (uint64_t)modes[i].htotal * modes[i].vtotal;
+        uint32_t hz = (uint32_t)(modes[i].dot_clock / frame);
+        return hz ? (uint16_t)hz : DEFAULT_HZ;
+    }
+    return DEFAULT_HZ;
+}
+
+static int32_t crtc_has_output(xcb_randr_get_crtc_info_reply_t *r,
+                               xcb_randr_output_t output)
+{
+    xcb_randr_output_t *outs = xcb_randr_get_crtc_info_outputs(r);
+    int n = xcb_randr_get_crtc_info_outputs_length(r);
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (outs[i] == output) return 1;
+    }
+    return 0;
+}
+
+static uint16_t query_outputs(struct qwm_t *qwm, output_rect_t *out)
+{
+    uint16_t n = 0;
+
+    if (qwm->randr_event_base)
+    {
+        xcb_randr_get_output_primary_cookie_t prim_ck =
+            xcb_randr_get_output_primary(qwm->conn, qwm->root);
+        xcb_randr_get_screen_resources_current_reply_t *res =
+            xcb_randr_get_screen_resources_current_reply(
+                qwm->conn,
+                xcb_randr_get_screen_resources_current(qwm->conn, qwm->root),
+                NULL);
+        xcb_randr_get_output_primary_reply_t *prim =
+            xcb_randr_get_output_primary_reply(qwm->conn, prim_ck, NULL);
+
+        if (res)
+        {
+            xcb_randr_crtc_t *crtcs =
+                xcb_randr_get_screen_resources_current_crtcs(res);
+            int count =
+                xcb_randr_get_screen_resources_current_crtcs_length(res);
+            if (count > MAX_CRTCS) count = MAX_CRTCS;
+
+            // send every query before waiting on the first reply
+            xcb_randr_get_crtc_info_cookie_t ck[MAX_CRTCS];
+            for (int i = 0; i < count; ++i)
+                ck[i] = xcb_randr_get_crtc_info(qwm->conn, crtcs[i],
+                                                res->config_timestamp);
+
+            for (int i = 0; i < count; ++i)
+            {
+                xcb_randr_get_crtc_info_reply_t *r =
+                    xcb_randr_get_crtc_info_reply(qwm->conn, ck[i], NULL);
+                if (!r) continue;
+
+                int32_t usable = r->mode != XCB_NONE && r->num_outputs > 0 &&
+                                 r->width && r->height && n < MAX_MONITORS;
+
+                // cloned outputs share one crtc rect, keep the first
+                for (uint16_t j = 0; usable && j < n; ++j)
+                {
+                    if (out[j].x == r->x && out[j].y == r->y &&
+                        out[j].w == r->width && out[j].h == r->height)
+                        usable = 0;
+                }
+
+                if (usable)
+                {
+                    out[n] = (output_rect_t){crtcs[i], r->x, r->y, r->width,
+                                             r->height,
+                                             mode_refresh(res, r->mode)};
+
+                    // primary output always ends up in front
+                    if (n && prim && crtc_has_output(r, prim->output))
+                    {
+                        output_rect_t tmp = out[0];
+                        out[0] = out[n];
+                        out[n] = tmp;
+                    }
+                    n++;
+                }
+                free(r);
+            }
+        }
+
+        free(prim);
+        free(res);
+    }
+
+    if (n == 0)
+    {
+        out[0] =
+            (output_rect_t){XCB_NONE, 0, 0, qwm->w, qwm->h, DEFAULT_HZ};
+        n = 1;
+    }
+
+    return n;
+}
+
+static void relayout_monitor(struct qwm_t *qwm, uint16_t m)
+{
+    for (uint16_t k = 0; k < WORKSPACE_COUNT; ++k)
+        layout_apply(qwm, (uint16_t)(m * WORKSPACE_COUNT + k));
+}
+
+static void monitor_activate(struct qwm_t *qwm, uint16_t m,
+                             const output_rect_t *o)
+{
+    monitor_t *mon = &qwm->monitors[m];
+
+    mon->crtc = o->crtc;
+    mon->x = o->x;
+    mon->y = o->y;
+    mon->w = o->w;
+    mon->h = o->h;
+    mon->refresh_hz = o->hz;
+    mon->cur_ws = (uint16_t)(m * WORKSPACE_COUNT);
+    mon->active = 1;
+
+    taskbar_init(qwm, &mon->taskbar, m);
+}
+
+// hand every client of monitor m over to the same workspace number on dst
+static void monitor_evacuate(struct qwm_t *qwm, uint16_t m, uint16_t dst)
+{
+    monitor_t *src = &qwm->monitors[m];
+    if (m == dst) return;
+
+    for (uint16_t k = 0; k < WORKSPACE_COUNT; ++k)
+    {
+        uint16_t to_idx = (uint16_t)(dst * WORKSPACE_COUNT + k);
+        workspace_t *from = &qwm->workspaces[m * WORKSPACE_COUNT + k];
+        workspace_t *to = &qwm->workspaces[to_idx];
+        if (!from->clients) continue;
+
+        int32_t visible = monitor_ws_visible(qwm, to_idx);
+        client_t *last = NULL;
+
+        for (client_t *c = from->clients; c; c = c->next)
+        {
+            place_remove(qwm, c);
+            c->workspace = to_idx;
+            ewmh_set_client_desktop(qwm, c);
+
+            // the layout below maps whatever should show
+            if (!visible) client_show(qwm, c, 0);
+            last = c;
+        }
+
+        last->next = to->clients;
+        to->clients = from->clients;
+
+        if (!to->focused)
+            to->focused = from->focused;
+        else if (from->focused)
+            client_set_focus(qwm, from->focused, 0);
+
+        from->clients = NULL;
+        from->focused = NULL;
+
+        if (visible) layout_apply(qwm, to_idx);
+    }
+
+    taskbar_kill(qwm, &src->taskbar);
+    memset(&src->taskbar, 0, sizeof(src->taskbar));
+    src->crtc = XCB_NONE;
+    src->active = 0;
+}
+
+/*****************************
+ * MONITOR
+ *****************************/
+
+void monitor_init(struct qwm_t *qwm)
+{
+    const xcb_query_extension_reply_t *ext =
+        xcb_get_extension_data(qwm->conn, &xcb_randr_id);
+
+    if (ext && ext->present)
+    {
+        // screen_resources_current needs 1.3
+        xcb_randr_query_version_reply_t *ver = xcb_randr_query_version_reply(
+            qwm->conn, xcb_randr_query_version(qwm->conn, 1, 3), NULL);
+
+        if (ver && (ver->major_version > 1 || ver->minor_version >= 3))
+        {
+            qwm->randr_event_base = ext->first_event;
+            xcb_randr_select_input(qwm->conn, qwm->root,
+                                   XCB_RANDR_NOTIFY_MASK_SCREEN_CHANGE);
+        }
+        free(ver);
+    }
+
+    monitor_update(qwm);
+}
+
+void monitor_kill(struct qwm_t *qwm)
+{
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+    {
+        if (qwm->monitors[m].active)
+            taskbar_kill(qwm, &qwm->monitors[m].taskbar);
+    }
+}
+
+void monitor_update(struct qwm_t *qwm)
+{
+    output_rect_t outs[MAX_MONITORS];
+    uint16_t n = query_outputs(qwm, outs);
+
+    int16_t slot_of[MAX_MONITORS];
+    uint8_t keep[MAX_MONITORS] = {0};
+    int16_t target = -1;
+
+    // known outputs keep their slot, and with it their workspaces
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        slot_of[i] = -1;
+        for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+        {
+            monitor_t *mon = &qwm->monitors[m];
+            if (mon->active && !keep[m] && mon->crtc == outs[i].crtc)
+            {
+                slot_of[i] = (int16_t)m;
+                keep[m] = 1;
+                if (target < 0) target = (int16_t)m;
+                break;
+            }
+        }
+    }
+
+    // nothing survived: the first output takes over a stale slot, so
+    // its workspaces have somewhere to go even when no slot is free
+    for (uint16_t m = 0; target < 0 && m < MAX_MONITORS; ++m)
+    {
+        monitor_t *mon = &qwm->monitors[m];
+        if (!mon->active) continue;
+
+        mon->crtc = outs[0].crtc;
+        slot_of[0] = (int16_t)m;
+        keep[m] = 1;
+        target = (int16_t)m;
+
+        // forces the move below, the new output can share the old rect
+        mon->w = 0;
+    }
+
+    // only outputs whose rect actually moved get a relayout
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        if (slot_of[i] < 0) continue;
+
+        monitor_t *mon = &qwm->monitors[slot_of[i]];
+        mon->refresh_hz = outs[i].hz;
+        if (mon->x == outs[i].x && mon->y == outs[i].y &&
+            mon->w == outs[i].w && mon->h == outs[i].h)
+            continue;
+
+        mon->x = outs[i].x;
+        mon->y = outs[i].y;
+        mon->w = outs[i].w;
+        mon->h = outs[i].h;
+
+        taskbar_place(qwm, &mon->taskbar);
+        relayout_monitor(qwm, (uint16_t)slot_of[i]);
+    }
+
+    // free the slots of unplugged outputs before handing out new ones
+    for (uint16_t m = 0; target >= 0 && m < MAX_MONITORS; ++m)
+    {
+        if (qwm->monitors[m].active && !keep[m])
+            monitor_evacuate(qwm, m, (uint16_t)target);
+    }
+
+    for (uint16_t i = 0; i < n; ++i)
+    {
+        if (slot_of[i] >= 0) continue;
+
+        for (uint16_t f = 0; f < MAX_MONITORS; ++f)
+        {
+            if (qwm->monitors[f].active) continue;
+
+            monitor_activate(qwm, f, &outs[i]);
+            slot_of[i] = (int16_t)f;
+            keep[f] = 1;
+            break;
+        }
+    }
+
+    // no monitor was active before, nothing to evacuate
+    if (target < 0) target = slot_of[0] >= 0 ? slot_of[0] : 0;
+
+    if (!qwm->monitors[qwm->current_mon].active)
+    {
+        qwm->current_mon = (uint16_t)target;
+        qwm->current_ws = qwm->monitors[target].cur_ws;
+        ewmh_set_current_desktop(qwm);
+    }
+
+    uint16_t last = 0;
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+    {
+        if (qwm->monitors[m].active) last = m;
+    }
+    ewmh_set_desktop_count(qwm, (uint32_t)(last + 1) * WORKSPACE_COUNT);
+}
+
+monitor_t *monitor_of_ws(struct qwm_t *qwm, uint16_t ws)
+{
+    return &qwm->monitors[WS_MONITOR(ws)];
+}
+
+int32_t monitor_ws_visible(struct qwm_t *qwm, uint16_t ws)
+{
+    monitor_t *mon = monitor_of_ws(qwm, ws);
+    return mon->active && mon->cur_ws == ws;
+}
+
+monitor_t *monitor_next(struct qwm_t *qwm, uint16_t from)
+{
+    for (uint16_t i = 1; i <= MAX_MONITORS; ++i)
+    {
+        monitor_t *mon = &qwm->monitors[(from + i) % MAX_MONITORS];
+        if (mon->active) return mon;
+    }
+    return &qwm->monitors[from];
+}
+
+taskbar_t *monitor_bar_of(struct qwm_t *qwm, xcb_window_t win)
+{
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+    {
+        monitor_t *mon = &qwm->monitors[m];
+        if (mon->active && mon->taskbar.win == win) return &mon->taskbar;
+    }
+    return NULL;
+}
+
+uint16_t monitor_sync_bars(struct qwm_t *qwm)
+{
+    uint16_t visible = 0;
+
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+    {
+        monitor_t *mon = &qwm->monitors[m];
+        if (!mon->active) continue;
+
+        client_t *f = qwm->workspaces[mon->cur_ws].focused;
+        int32_t covered = f && f->fullscreen && f->mapped;
+
+        taskbar_set_hidden(qwm, &mon->taskbar, covered);
+        if (!covered) visible++;
+    }
+    return visible;
+}
@@ -0,0 +1,38 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include "taskbar.h"
+
+#include <xcb/randr.h>
+
+struct qwm_t;
+
+typedef struct {
+    xcb_randr_crtc_t crtc; // XCB_NONE for the no-RandR fallback
+    int16_t x, y;
+    uint16_t w, h;
+    uint16_t refresh_hz; // of the current mode, 60 when unknown
+    uint16_t cur_ws;     // index into qwm->workspaces
+    uint8_t active;
+    taskbar_t taskbar;
+} monitor_t;
+
+void monitor_init(struct qwm_t *qwm);
+
+void monitor_kill(struct qwm_t *qwm);
+
+void monitor_update(struct qwm_t *qwm);
+
+monitor_t *monitor_of_ws(struct qwm_t *qwm, uint16_t ws);
+
+int32_t monitor_ws_visible(struct qwm_t *qwm, uint16_t ws);
+
+monitor_t *monitor_next(struct qwm_t *qwm, uint16_t from);
+
+taskbar_t *monitor_bar_of(struct qwm_t *qwm, xcb_window_t win);
+
+// hide bars whose output shows a focused fullscreen client, returns the
+// number of bars still visible
+uint16_t monitor_sync_bars(struct qwm_t *qwm);
+
+#endif // MONITOR_H
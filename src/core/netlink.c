@@ -0,0 +1,400 @@
+#include "qwm.h"
+#include "netlink.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <poll.h>       // poll, POLLIN
+#include <unistd.h>     // close
+#include <sys/socket.h> // socket, bind, send, recv
+#include <sys/time.h>   // struct timeval
+#include <linux/if.h>   // IFF_UP, IFF_RUNNING, IFF_LOOPBACK
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/genetlink.h>
+#include <linux/nl80211.h>
+
+#define NL_BUF_SIZE 8192
+#define NL_TIMEOUT_MS 1000 // startup dumps and nl80211 replies
+
+typedef struct {
+    struct nlmsghdr h;
+    struct genlmsghdr g;
+    struct nlattr a;
+    char value[16];
+} genl_req_t;
+
+static const struct nlattr *attr_find(const void *p, uint32_t len,
+                                      uint16_t type)
+{
+    const struct nlattr *a = p;
+
+    while (len >= NLA_HDRLEN && a->nla_len >= NLA_HDRLEN && a->nla_len <= len)
+    {
+        if ((a->nla_type & NLA_TYPE_MASK) == type) return a;
+
+        uint32_t step = NLA_ALIGN(a->nla_len);
+        if (step >= len) break;
+        len -= step;
+        a = (const struct nlattr *)((const char *)a + step);
+    }
+    return NULL;
+}
+
+static uint32_t attr_len(const struct nlattr *a)
+{
+    return a->nla_len - NLA_HDRLEN;
+}
+
+static const void *attr_data(const struct nlattr *a)
+{
+    return (const char *)a + NLA_HDRLEN;
+}
+
+static net_link_t *link_get(netlink_t *nl, int32_t index, int32_t add)
+{
+    net_link_t *free_slot = NULL;
+
+    for (uint32_t i = 0; i < NET_MAX_LINKS; ++i)
+    {
+        net_link_t *l = &nl->links[i];
+        if (l->index == index) return l;
+        if (!l->index && !free_slot) free_slot = l;
+    }
+    if (!add || !free_slot) return NULL;
+
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->index = index;
+    free_slot->query = 1;
+    return free_slot;
+}
+
+/*****************************
+ * NL80211
+ *****************************/
+
+// one request, one reply; NULL on error or timeout
+static const struct nlmsghdr *genl_call(netlink_t *nl, genl_req_t *req,
+                                        char *buf)
+{
+    req->h.nlmsg_flags = NLM_F_REQUEST;
+    req->h.nlmsg_seq = ++nl->seq;
+    if (send(nl->genl_fd, req, req->h.nlmsg_len, 0) < 0) return NULL;
+
+    for (;;)
+    {
+        ssize_t n = recv(nl->genl_fd, buf, NL_BUF_SIZE, 0);
+        if (n < 0) return NULL;
+
+        const struct nlmsghdr *h = (const struct nlmsghdr *)buf;
+        if (!NLMSG_OK(h, (uint32_t)n)) return NULL;
+        if (h->nlmsg_seq != nl->seq) continue; // late reply of a timeout
+        if (h->nlmsg_type == NLMSG_ERROR) return NULL;
+        return h;
+    }
+}
+
+static void genl_req(genl_req_t *req, uint16_t family, uint8_t cmd,
+                     uint16_t attr, const void *value, uint16_t len)
+{
+    memset(req, 0, sizeof(*req));
+    req->h.nlmsg_type = family;
+    req->g.cmd = cmd;
+    req->g.version = 1;
+    req->a.nla_type = attr;
+    req->a.nla_len = (uint16_t)(NLA_HDRLEN + len);
+    memcpy(req->value, value, len);
+    req->h.nlmsg_len = (uint32_t)(NLMSG_LENGTH(GENL_HDRLEN) +
+                                  NLA_ALIGN(req->a.nla_len));
+}
+
+static void genl_open(netlink_t *nl)
+{
+    nl->genl_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (nl->genl_fd < 0) return;
+
+    // replies come right back, this only guards a stuck kernel; without
+    // it a blocking recv could hang the X thread, so no Wi-Fi then
+    struct timeval tv = {NL_TIMEOUT_MS / 1000, (NL_TIMEOUT_MS % 1000) * 1000};
+    if (setsockopt(nl->genl_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0)
+    {
+        close(nl->genl_fd);
+        nl->genl_fd = -1;
+        return;
+    }
+
+    genl_req_t req;
+    char buf[NL_BUF_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+    genl_req(&req, GENL_ID_CTRL, CTRL_CMD_GETFAMILY, CTRL_ATTR_FAMILY_NAME,
+             NL80211_GENL_NAME, sizeof(NL80211_GENL_NAME));
+
+    const struct nlmsghdr *h = genl_call(nl, &req, buf);
+    const struct nlattr *id =
+        h ? attr_find((const char *)NLMSG_DATA(h) + GENL_HDRLEN,
+                      h->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN),
+                      CTRL_ATTR_FAMILY_ID)
+          : NULL;
+
+    if (id && attr_len(id) >= sizeof(uint16_t))
+    {
+        memcpy(&nl->nl80211, attr_data(id), sizeof(uint16_t));
+        return;
+    }
+
+    // no cfg80211 loaded, every link is wired
+    close(nl->genl_fd);
+    nl->genl_fd = -1;
+}
+
+// non Wi-Fi links answer with an error
+static void wifi_query(netlink_t *nl, net_link_t *l)
+{
+    l->query = 0;
+    l->wifi = 0;
+    l->ssid[0] = '\0';
+    if (nl->genl_fd < 0) return;
+
+    genl_req_t req;
+    char buf[NL_BUF_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+    uint32_t index = (uint32_t)l->index;
+    genl_req(&req, nl->nl80211, NL80211_CMD_GET_INTERFACE,
+             NL80211_ATTR_IFINDEX, &index, sizeof(index));
+
+    const struct nlmsghdr *h = genl_call(nl, &req, buf);
+    if (!h || h->nlmsg_type != nl->nl80211) return;
+
+    l->wifi = 1;
+
+    // only there while associated
+    const struct nlattr *ssid =
+        attr_find((const char *)NLMSG_DATA(h) + GENL_HDRLEN,
+                  h->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN), NL80211_ATTR_SSID);
+    if (!ssid) return;
+
+    uint32_t n = attr_len(ssid);
+    if (n >= sizeof(l->ssid)) n = sizeof(l->ssid) - 1;
+    memcpy(l->ssid, attr_data(ssid), n);
+    l->ssid[n] = '\0';
+}
+
+/*****************************
+ * RTNETLINK
+ *****************************/
+
+static void rt_link(netlink_t *nl, const struct nlmsghdr *h)
+{
+    const struct ifinfomsg *ifi = NLMSG_DATA(h);
+    if (ifi->ifi_flags & IFF_LOOPBACK) return;
+
+    if (h->nlmsg_type == RTM_DELLINK)
+    {
+        net_link_t *l = link_get(nl, ifi->ifi_index, 0);
+        if (l) l->index = 0;
+        return;
+    }
+
+    net_link_t *l = link_get(nl, ifi->ifi_index, 1);
+    if (!l) return;
+
+    const struct nlattr *name =
+        attr_find((const char *)ifi + NLMSG_ALIGN(sizeof(*ifi)),
+                  h->nlmsg_len - NLMSG_LENGTH(sizeof(*ifi)), IFLA_IFNAME);
+    if (name)
+    {
+        snprintf(l->name, sizeof(l->name), "%.*s", (int)attr_len(name),
+                 (const char *)attr_data(name));
+    }
+
+    // drivers also send NEWLINK for wireless events, only state counts
+    uint8_t up = (ifi->ifi_flags & IFF_UP) && (ifi->ifi_flags & IFF_RUNNING);
+    if (up != l->up) l->query = 1;
+    l->up = up;
+}
+
+static void rt_addr(netlink_t *nl, const struct nlmsghdr *h)
+{
+    const struct ifaddrmsg *ifa = NLMSG_DATA(h);
+    if (ifa->ifa_family != AF_INET) return;
+
+    net_link_t *l = link_get(nl, (int32_t)ifa->ifa_index, 0);
+    if (!l) return;
+
+    const char *attrs = (const char *)ifa + NLMSG_ALIGN(sizeof(*ifa));
+    uint32_t len = h->nlmsg_len - NLMSG_LENGTH(sizeof(*ifa));
+    const struct nlattr *a = attr_find(attrs, len, IFA_LOCAL);
+    if (!a) a = attr_find(attrs, len, IFA_ADDRESS);
+    if (!a || attr_len(a) < sizeof(uint32_t)) return;
+
+    uint32_t addr;
+    memcpy(&addr, attr_data(a), sizeof(addr));
+
+    for (uint8_t i = 0; i < l->addr_count; ++i)
+    {
+        if (l->addr[i] != addr) continue;
+
+        if (h->nlmsg_type == RTM_DELADDR)
+            l->addr[i] = l->addr[--l->addr_count];
+        return; // NEWADDR repeats on lifetime updates
+    }
+
+    if (h->nlmsg_type == RTM_NEWADDR && l->addr_count < NET_MAX_ADDRS)
+        l->addr[l->addr_count++] = addr;
+}
+
+// returns 1 once the dump of seq is complete
+static int32_t rt_parse(netlink_t *nl, char *buf, uint32_t len, uint32_t seq)
+{
+    int32_t done = 0;
+
+    for (struct nlmsghdr *h = (struct nlmsghdr *)buf; NLMSG_OK(h, len);
+         h = NLMSG_NEXT(h, len))
+    {
+        switch (h->nlmsg_type)
+        {
+        case NLMSG_DONE:
+        case NLMSG_ERROR:
+            if (seq && h->nlmsg_seq == seq) done = 1;
+            break;
+        case RTM_NEWLINK:
+        case RTM_DELLINK: rt_link(nl, h); break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR: rt_addr(nl, h); break;
+        default: break;
+        }
+    }
+    return done;
+}
+
+// reads until the socket is empty; -1 when the kernel dropped messages
+static int32_t rt_drain(netlink_t *nl, uint32_t seq)
+{
+    char buf[NL_BUF_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+    int32_t done = 0;
+
+    for (;;)
+    {
+        ssize_t n = recv(nl->fd, buf, sizeof(buf), 0);
+        if (n > 0)
+        {
+            done |= rt_parse(nl, buf, (uint32_t)n, seq);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == ENOBUFS) return -1;
+        return done;
+    }
+}
+
+static void rt_dump(netlink_t *nl, uint16_t type, uint32_t body)
+{
+    struct {
+        struct nlmsghdr h;
+        char body[sizeof(struct ifinfomsg)];
+    } req;
+
+    memset(&req, 0, sizeof(req));
+    req.h.nlmsg_len = NLMSG_LENGTH(body);
+    req.h.nlmsg_type = type;
+    req.h.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.h.nlmsg_seq = ++nl->seq;
+    req.body[0] = AF_UNSPEC; // family leads both ifinfomsg and ifaddrmsg
+    if (send(nl->fd, &req, req.h.nlmsg_len, 0) < 0) return;
+
+    struct pollfd pfd = {.fd = nl->fd, .events = POLLIN};
+    while (poll(&pfd, 1, NL_TIMEOUT_MS) > 0)
+    {
+        if (rt_drain(nl, req.h.nlmsg_seq) > 0) break;
+    }
+}
+
+// from scratch, at startup and after an overrun lost events
+static void rt_sync(netlink_t *nl)
+{
+    memset(nl->links, 0, sizeof(nl->links));
+
+    // one dump at a time, the kernel refuses a second one meanwhile
+    rt_dump(nl, RTM_GETLINK, sizeof(struct ifinfomsg));
+    rt_dump(nl, RTM_GETADDR, sizeof(struct ifaddrmsg));
+}
+
+/*****************************
+ * STATUS
+ *****************************/
+
+static int32_t net_status(struct qwm_t *wm)
+{
+    netlink_t *nl = &wm->net;
+    const net_link_t *best = NULL;
+
+    for (uint32_t i = 0; i < NET_MAX_LINKS; ++i)
+    {
+        net_link_t *l = &nl->links[i];
+        if (!l->index) continue;
+        if (l->query) wifi_query(nl, l);
+        if (!l->up || !l->addr_count) continue;
+
+        if (!best || (best->wifi && !l->wifi)) best = l;
+    }
+
+    connection_t *conn = &wm->tray.connection;
+    connect_state_t state = best ? CONNECT : DISCONNECT;
+    connect_type_t type = !best ? UNKNOWN : best->wifi ? WIFI : LAN;
+    const char *name = !best ? "" : best->wifi ? best->ssid : best->name;
+
+    if (conn->cn_state == state && conn->cn_type == type &&
+        strcmp(conn->name, name) == 0)
+        return 0;
+
+    conn->cn_state = state;
+    conn->cn_type = type;
+    snprintf(conn->name, sizeof(conn->name), "%s", name);
+    return 1;
+}
+
+/*****************************
+ * NETLINK
+ *****************************/
+
+void netlink_init(struct qwm_t *wm)
+{
+    netlink_t *nl = &wm->net;
+    memset(nl, 0, sizeof(*nl));
+    nl->genl_fd = -1;
+
+    nl->fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                    NETLINK_ROUTE);
+    if (nl->fd < 0) return;
+
+    struct sockaddr_nl addr = {.nl_family = AF_NETLINK,
+                               .nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR};
+    if (bind(nl->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(nl->fd);
+        nl->fd = -1;
+        return;
+    }
+
+    genl_open(nl);
+    rt_sync(nl);
+    net_status(wm);
+}
+
+void netlink_kill(struct qwm_t *wm)
+{
+    netlink_t *nl = &wm->net;
+
+    if (nl->fd >= 0) close(nl->fd);
+    if (nl->genl_fd >= 0) close(nl->genl_fd);
+    nl->fd = -1;
+    nl->genl_fd = -1;
+}
+
+int32_t netlink_handle(struct qwm_t *wm)
+{
+    netlink_t *nl = &wm->net;
+    if (nl->fd < 0) return 0;
+
+    if (rt_drain(nl, 0) < 0) rt_sync(nl);
+    return net_status(wm);
+}
@@ -0,0 +1,49 @@
+/*
+ * Network status over netlink
+ * An rtnetlink socket subscribed to link and IPv4 address changes sits in
+ * the qwm_run poll set, so the tray follows cable pulls and Wi-Fi joins as
+ * they happen instead of asking NetworkManager. A link counts as connected
+ * when it is up, running and has an IPv4 address; wired wins over Wi-Fi.
+ *
+ * Wi-Fi links are told apart and named by one nl80211 GET_INTERFACE query
+ * whenever a link shows up or goes up or down, never on a timer.
+ */
+
+#ifndef NETLINK_H
+#define NETLINK_H
+
+#include <stdint.h>
+
+struct qwm_t;
+
+#define NET_MAX_LINKS 16
+#define NET_MAX_ADDRS 4 // IPv4 addresses tracked per link
+
+typedef struct {
+    int32_t index; // 0 marks a free entry
+    uint32_t addr[NET_MAX_ADDRS];
+    uint8_t addr_count;
+    uint8_t up;    // IFF_UP and IFF_RUNNING
+    uint8_t wifi;
+    uint8_t query; // nl80211 lookup due after this batch
+    char name[16];
+    char ssid[33];
+} net_link_t;
+
+typedef struct {
+    int fd;      // rtnetlink, -1 without
+    int genl_fd; // nl80211 queries, -1 without
+    uint16_t nl80211; // generic netlink family id
+    uint32_t seq;
+    net_link_t links[NET_MAX_LINKS];
+} netlink_t;
+
+// dumps links and addresses once, fills qwm->tray.connection
+void netlink_init(struct qwm_t *wm);
+
+void netlink_kill(struct qwm_t *wm);
+
+// drains the socket, returns 1 when the shown connection changed
+int32_t netlink_handle(struct qwm_t *wm);
+
+#endif // NETLINK_H
@@ -0,0 +1,246 @@
+#include "qwm.h"
+#include "place.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BW BORDER_WIDTH
+
+typedef struct {
+    uint16_t x, y, w, h;
+} cell_rect_t;
+
+static void area_of(struct qwm_t *wm, uint16_t ws, int32_t *x, int32_t *y,
+                    uint32_t *w, uint32_t *h)
+{
+    monitor_t *m = monitor_of_ws(wm, ws);
+
+    *x = m->x;
+    *y = m->y;
+    *w = m->w;
+    *h = m->h > m->taskbar.height ? m->h - m->taskbar.height : m->h;
+}
+
+// cells covered by the client's floating rect, border included
+static cell_rect_t cells_of(struct qwm_t *wm, uint16_t ws, const place_t *p,
+                            const client_t *c)
+{
+    int32_t ax, ay;
+    uint32_t aw, ah;
+    area_of(wm, ws, &ax, &ay, &aw, &ah);
+
+    int32_t x0 = ((int32_t)c->fx - ax) / PLACE_CELL;
+    int32_t y0 = ((int32_t)c->fy - ay) / PLACE_CELL;
+    int32_t x1 = ((int32_t)(c->fx + c->fw + 2 * BW) - ax + PLACE_CELL - 1) /
+                 PLACE_CELL;
+    int32_t y1 = ((int32_t)(c->fy + c->fh + 2 * BW) - ay + PLACE_CELL - 1) /
+                 PLACE_CELL;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > p->cols) x1 = p->cols;
+    if (y1 > p->rows) y1 = p->rows;
+    if (x1 < x0) x1 = x0;
+    if (y1 < y0) y1 = y0;
+
+    return (cell_rect_t){(uint16_t)x0, (uint16_t)y0, (uint16_t)(x1 - x0),
+                         (uint16_t)(y1 - y0)};
+}
+
+static void occupy(place_t *p, cell_rect_t r, int32_t delta)
+{
+    for (uint16_t y = r.y; y < r.y + r.h; ++y)
+    {
+        uint16_t *row = &p->cells[(uint32_t)y * p->cols];
+        for (uint16_t x = r.x; x < r.x + r.w; ++x)
+            row[x] = (uint16_t)(row[x] + delta);
+    }
+}
+
+static void client_occupy(struct qwm_t *wm, client_t *c)
+{
+    place_t *p = &wm->workspaces[c->workspace].place;
+    cell_rect_t r = cells_of(wm, c->workspace, p, c);
+
+    occupy(p, r, 1);
+    c->place_ws = c->workspace;
+    c->cell_x = r.x;
+    c->cell_y = r.y;
+    c->cell_w = r.w;
+    c->cell_h = r.h;
+    c->placed = 1;
+}
+
+// Largest empty rectangle, preferring ones that fit need_w x need_h
+// cells. Each row turns the grid into a histogram of free run lengths,
+// and every bar popped off the stack is a maximal free rectangle.
+static int32_t largest_free(place_t *p, uint16_t need_w, uint16_t need_h,
+                            cell_rect_t *out)
+{
+    uint16_t *height = p->scan;
+    uint16_t *stack = p->scan + p->cols + 1;
+    uint32_t best_fit = 0, best_any = 0;
+    cell_rect_t any = {0, 0, 0, 0};
+
+    memset(height, 0, (p->cols + 1) * sizeof(*height));
+
+    for (uint16_t r = 0; r < p->rows; ++r)
+    {
+        const uint16_t *row = &p->cells[(uint32_t)r * p->cols];
+        for (uint16_t x = 0; x < p->cols; ++x)
+            height[x] = row[x] ? 0 : (uint16_t)(height[x] + 1);
+
+        uint16_t top = 0;
+        for (uint16_t i = 0; i <= p->cols; ++i)
+        {
+            // height[cols] stays 0 and flushes the stack
+            while (top && height[stack[top - 1]] >= height[i])
+            {
+                uint16_t h = height[stack[--top]];
+                uint16_t left = top ? (uint16_t)(stack[top - 1] + 1) : 0;
+                uint16_t w = (uint16_t)(i - left);
+                uint32_t area = (uint32_t)w * h;
+
+                cell_rect_t rect = {left, (uint16_t)(r + 1 - h), w, h};
+                if (w >= need_w && h >= need_h && area > best_fit)
+                {
+                    best_fit = area;
+                    *out = rect;
+                }
+                if (area > best_any)
+                {
+                    best_any = area;
+                    any = rect;
+                }
+            }
+            stack[top++] = i;
+        }
+    }
+
+    if (best_fit) return 1;
+    *out = any;
+    return 0;
+}
+
+static void place_client(struct qwm_t *wm, uint16_t ws, client_t *c)
+{
+    place_t *p = &wm->workspaces[ws].place;
+
+    int32_t ax, ay;
+    uint32_t aw, ah;
+    area_of(wm, ws, &ax, &ay, &aw, &ah);
+
+    // same size rules as layout_floating
+    uint32_t max_w = aw > 2 * BW ? aw - 2 * BW : aw;
+    uint32_t max_h = ah > 2 * BW ? ah - 2 * BW : ah;
+    if (!c->fw) c->fw = max_w * 6 / 10;
+    if (!c->fh) c->fh = max_h * 6 / 10;
+    if (c->fw < MIN_W) c->fw = MIN_W;
+    if (c->fh < MIN_H) c->fh = MIN_H;
+    if (c->fw > max_w) c->fw = max_w;
+    if (c->fh > max_h) c->fh = max_h;
+
+    uint32_t out_w = c->fw + 2 * BW;
+    uint32_t out_h = c->fh + 2 * BW;
+    uint16_t need_w = (uint16_t)((out_w + PLACE_CELL - 1) / PLACE_CELL);
+    uint16_t need_h = (uint16_t)((out_h + PLACE_CELL - 1) / PLACE_CELL);
+
+    cell_rect_t r;
+    int32_t fits = largest_free(p, need_w, need_h, &r);
+
+    int32_t x = ax + r.x * PLACE_CELL;
+    int32_t y = ay + r.y * PLACE_CELL;
+
+    // centred in the free area, or its corner when the window is bigger
+    if (fits)
+    {
+        x += (int32_t)(r.w * PLACE_CELL - out_w) / 2;
+        y += (int32_t)(r.h * PLACE_CELL - out_h) / 2;
+    }
+    if (x + (int32_t)out_w > ax + (int32_t)aw)
+        x = ax + (int32_t)aw - (int32_t)out_w;
+    if (y + (int32_t)out_h > ay + (int32_t)ah)
+        y = ay + (int32_t)ah - (int32_t)out_h;
+    if (x < ax) x = ax;
+    if (y < ay) y = ay;
+
+    c->fx = (uint32_t)x;
+    c->fy = (uint32_t)y;
+    client_occupy(wm, c);
+}
+
+// (re)size the grid for the monitor, recounting placed clients on change
+static int32_t grid_sync(struct qwm_t *wm, uint16_t ws)
+{
+    place_t *p = &wm->workspaces[ws].place;
+
+    int32_t ax, ay;
+    uint32_t aw, ah;
+    area_of(wm, ws, &ax, &ay, &aw, &ah);
+
+    uint16_t cols = (uint16_t)((aw + PLACE_CELL - 1) / PLACE_CELL);
+    uint16_t rows = (uint16_t)((ah + PLACE_CELL - 1) / PLACE_CELL);
+    if (p->cells && cols == p->cols && rows == p->rows) return 1;
+
+    uint16_t *cells = realloc(p->cells, (size_t)cols * rows * sizeof(*cells));
+    if (!cells) return 0;
+    p->cells = cells;
+
+    uint16_t *scan = realloc(p->scan, 2 * (size_t)(cols + 1) * sizeof(*scan));
+    if (!scan) return 0;
+    p->scan = scan;
+
+    p->cols = cols;
+    p->rows = rows;
+    memset(p->cells, 0, (size_t)cols * rows * sizeof(*cells));
+
+    for (client_t *c = wm->workspaces[ws].clients; c; c = c->next)
+    {
+        if (c->placed) client_occupy(wm, c);
+    }
+    return 1;
+}
+
+/*****************************
+ * PLACE
+ *****************************/
+
+void place_kill(place_t *p)
+{
+    free(p->cells);
+    free(p->scan);
+    memset(p, 0, sizeof(*p));
+}
+
+void place_workspace(struct qwm_t *wm, uint16_t ws)
+{
+    workspace_t *w = &wm->workspaces[ws];
+
+    for (client_t *c = w->clients; c; c = c->next)
+    {
+        if (c->placed || (w->type != LAYOUT_FLOAT && !c->floating)) continue;
+
+        // the grid is only read here, so it is resized lazily too
+        if (!grid_sync(wm, ws)) return;
+        place_client(wm, ws, c);
+    }
+}
+
+void place_remove(struct qwm_t *wm, client_t *c)
+{
+    if (!c->placed) return;
+
+    place_t *p = &wm->workspaces[c->place_ws].place;
+    cell_rect_t r = {c->cell_x, c->cell_y, c->cell_w, c->cell_h};
+
+    if (p->cells) occupy(p, r, -1);
+    c->placed = 0;
+}
+
+void place_update(struct qwm_t *wm, client_t *c)
+{
+    if (!c->placed) return;
+
+    place_remove(wm, c);
+    if (wm->workspaces[c->workspace].place.cells) client_occupy(wm, c);
+}
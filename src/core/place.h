@@ -0,0 +1,35 @@
+/*
+ * Floating placement
+ * Coarse occupancy grid per workspace. Every placed client adds 1 to the
+ * cells its floating rect covers and subtracts it again on removal, so
+ * the grid is kept up to date incrementally. New clients go into the
+ * largest free rectangle, found with the maximal-rectangle-in-histogram
+ * scan in O(cells).
+ */
+
+#ifndef PLACE_H
+#define PLACE_H
+
+#include "client.h"
+
+struct qwm_t;
+
+#define PLACE_CELL 16 // px per grid cell
+
+typedef struct {
+    uint16_t *cells; // number of clients covering each cell
+    uint16_t *scan;  // histogram + stack for the free rect search
+    uint16_t cols, rows;
+} place_t;
+
+void place_kill(place_t *p);
+
+// place every floating client of ws that isn't placed yet
+void place_workspace(struct qwm_t *wm, uint16_t ws);
+
+void place_remove(struct qwm_t *wm, client_t *c);
+
+// floating geometry of a placed client changed
+void place_update(struct qwm_t *wm, client_t *c);
+
+#endif // PLACE_H
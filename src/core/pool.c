@@ -0,0 +1,257 @@
+#include "qwm.h"
+#include "pool.h"
+#include "util.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define APP_COUNT (sizeof(my_pool) / sizeof(my_pool[0]))
+
+static void start(const char *cmd) { spawn("/bin/sh", "-c", cmd, NULL); }
+
+// start instances until parked + starting covers want and open claims
+static void pool_fill(pool_t *p, uint32_t app)
+{
+    pool_slot_t *s = &p->apps[app];
+
+    while (s->ready_count + s->pending < s->want + s->claims &&
+           s->ready_count + s->pending < POOL_MAX_READY)
+    {
+        start(my_pool[app].cmd);
+        s->started_ms[s->pending++] = monotonic_ms();
+        p->pending++;
+    }
+}
+
+// starts that never mapped stop counting, else a slot waits on them
+// forever and every MapRequest pays the WM_CLASS round trip
+static void pool_expire(pool_t *p)
+{
+    if (!p->pending) return;
+    uint64_t now = monotonic_ms();
+
+    for (uint32_t i = 0; i < p->app_count; ++i)
+    {
+        pool_slot_t *s = &p->apps[i];
+        uint8_t gone = 0;
+        while (gone < s->pending &&
+               now - s->started_ms[gone] >= POOL_START_MS)
+            gone++;
+        if (!gone) continue;
+
+        s->pending -= gone;
+        p->pending -= gone;
+        memmove(&s->started_ms[0], &s->started_ms[gone],
+                s->pending * sizeof(s->started_ms[0]));
+
+        // claims that were waiting on them are dropped, not retried
+        if (s->claims > s->pending) s->claims = s->pending;
+    }
+
+    if (p->scratch_pending && now - p->scratch_started_ms >= POOL_START_MS)
+    {
+        p->scratch_pending = 0;
+        p->pending--;
+    }
+}
+
+// compares the class half of WM_CLASS, "instance\0class\0"
+static int32_t class_is(xcb_get_property_reply_t *r, const char *class)
+{
+    if (!r || r->format != 8 || !class) return 0;
+
+    const char *v = xcb_get_property_value(r);
+    uint32_t len = (uint32_t)xcb_get_property_value_length(r);
+    uint32_t inst_len = (uint32_t)strnlen(v, len);
+    if (inst_len + 1 >= len) return 0;
+
+    const char *cls = v + inst_len + 1;
+    uint32_t cls_len = (uint32_t)strnlen(cls, len - inst_len - 1);
+    return strlen(class) == cls_len && memcmp(class, cls, cls_len) == 0;
+}
+
+static void adopt(struct qwm_t *wm, xcb_window_t win, uint8_t floating)
+{
+    client_t *c = qwm_manage(wm, win, wm->current_ws, floating, 1);
+    if (c && floating)
+    {
+        uint32_t v[] = {XCB_STACK_MODE_ABOVE};
+        xcb_configure_window(wm->conn, win, XCB_CONFIG_WINDOW_STACK_MODE, v);
+    }
+}
+
+/*****************************
+ * POOL
+ *****************************/
+
+void pool_init(struct qwm_t *wm)
+{
+    pool_t *p = &wm->pool;
+    memset(p, 0, sizeof(*p));
+    p->scratch = XCB_NONE;
+
+    p->app_count = APP_COUNT < POOL_MAX_APPS ? APP_COUNT : POOL_MAX_APPS;
+    for (uint32_t i = 0; i < p->app_count; ++i)
+    {
+        uint8_t n = my_pool[i].count;
+        p->apps[i].want = n < POOL_MAX_READY ? n : POOL_MAX_READY;
+        pool_fill(p, i);
+    }
+}
+
+void pool_kill(struct qwm_t *wm)
+{
+    pool_t *p = &wm->pool;
+
+    for (uint32_t i = 0; i < p->app_count; ++i)
+    {
+        pool_slot_t *s = &p->apps[i];
+        for (uint8_t r = 0; r < s->ready_count; ++r)
+            xcb_kill_client(wm->conn, s->ready[r]);
+        s->ready_count = 0;
+    }
+
+    // parked scratchpad only, an adopted one is a normal client
+    if (p->scratch != XCB_NONE && !client_find(wm, p->scratch))
+        xcb_kill_client(wm->conn, p->scratch);
+    p->scratch = XCB_NONE;
+}
+
+int32_t pool_map_request(struct qwm_t *wm, xcb_window_t win)
+{
+    pool_t *p = &wm->pool;
+    pool_expire(p);
+    if (!p->pending) return 0;
+
+    xcb_get_property_reply_t *cls = xcb_get_property_reply(
+        wm->conn,
+        xcb_get_property(wm->conn, 0, win, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING,
+                         0, 64),
+        NULL);
+
+    int32_t taken = 0;
+
+    if (p->scratch_pending && class_is(cls, SCRATCHPAD_CLASS))
+    {
+        p->scratch_pending = 0;
+        p->pending--;
+        p->scratch = win;
+        adopt(wm, win, 1);
+        taken = 1;
+    }
+
+    for (uint32_t i = 0; !taken && i < p->app_count; ++i)
+    {
+        pool_slot_t *s = &p->apps[i];
+        if (!s->pending || !class_is(cls, my_pool[i].class)) continue;
+
+        // the oldest start is the likeliest to be this one
+        s->pending--;
+        p->pending--;
+        memmove(&s->started_ms[0], &s->started_ms[1],
+                s->pending * sizeof(s->started_ms[0]));
+        taken = 1;
+
+        if (s->claims)
+        {
+            s->claims--;
+            adopt(wm, win, 0);
+        }
+        else
+        {
+            // parked: stays unmapped until claimed
+            s->ready[s->ready_count++] = win;
+        }
+    }
+
+    free(cls);
+    return taken;
+}
+
+int32_t pool_forget(struct qwm_t *wm, xcb_window_t win)
+{
+    pool_t *p = &wm->pool;
+
+    if (win == p->scratch)
+    {
+        p->scratch = XCB_NONE;
+        return !client_find(wm, win);
+    }
+
+    for (uint32_t i = 0; i < p->app_count; ++i)
+    {
+        pool_slot_t *s = &p->apps[i];
+        for (uint8_t r = 0; r < s->ready_count; ++r)
+        {
+            if (s->ready[r] != win) continue;
+
+            // not refilled here, an app dying on startup would loop
+            s->ready_count--;
+            memmove(&s->ready[r], &s->ready[r + 1],
+                    (s->ready_count - r) * sizeof(s->ready[0]));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*****************************
+ * CONFIG API
+ *****************************/
+
+void pool_claim(struct qwm_t *wm, uint32_t app)
+{
+    pool_t *p = &wm->pool;
+    if (app >= p->app_count) return;
+    pool_expire(p);
+
+    pool_slot_t *s = &p->apps[app];
+    if (s->ready_count)
+    {
+        xcb_window_t win = s->ready[0];
+        s->ready_count--;
+        memmove(&s->ready[0], &s->ready[1],
+                s->ready_count * sizeof(s->ready[0]));
+        adopt(wm, win, 0);
+    }
+    else
+    {
+        // nothing parked yet, the next one to map is adopted right away
+        s->claims++;
+    }
+
+    pool_fill(p, app);
+    xcb_flush(wm->conn);
+}
+
+void toggle_scratchpad(struct qwm_t *wm)
+{
+    pool_t *p = &wm->pool;
+
+    if (p->scratch == XCB_NONE)
+    {
+        pool_expire(p);
+        if (p->scratch_pending) return;
+        p->scratch_pending = 1;
+        p->scratch_started_ms = monotonic_ms();
+        p->pending++;
+        start(SCRATCHPAD_CMD);
+        return;
+    }
+
+    client_t *c = client_find(wm, p->scratch);
+    if (!c)
+    {
+        adopt(wm, p->scratch, 1);
+        xcb_flush(wm->conn);
+        return;
+    }
+
+    // park it again, pulled over instead when shown somewhere else
+    uint16_t ws = c->workspace;
+    client_show(wm, c, 0);
+    qwm_unmanage(wm, c);
+    if (ws != wm->current_ws) adopt(wm, p->scratch, 1);
+
+    xcb_flush(wm->conn);
+}
@@ -0,0 +1,58 @@
+/*
+ * Pre-started app pool and scratchpad
+ * my_pool in config.h lists apps to keep started in the background. Their
+ * windows are parked on MapRequest: never mapped, not on any workspace and
+ * not a client yet. pool_claim adopts a parked window onto the current
+ * workspace and starts a replacement, so claiming costs one map instead of
+ * an exec and toolkit startup.
+ *
+ * The scratchpad is one more parked window. toggle_scratchpad adopts it as
+ * a floating client and parks it again on the next toggle.
+ *
+ * A start that hasn't mapped after POOL_START_MS (crashed, missing binary,
+ * handed off to a running single-instance app) stops counting as pending,
+ * checked whenever a claim or MapRequest comes in.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <xcb/xcb.h>
+
+struct qwm_t;
+
+#define POOL_MAX_APPS 4
+#define POOL_MAX_READY 4 // parked windows per app
+#define POOL_START_MS 10000
+
+typedef struct {
+    xcb_window_t ready[POOL_MAX_READY]; // oldest first
+    uint64_t started_ms[POOL_MAX_READY]; // of each pending start, oldest first
+    uint8_t ready_count;
+    uint8_t pending; // started, MapRequest not seen yet
+    uint8_t claims;  // claimed while empty, adopted on arrival
+    uint8_t want;
+} pool_slot_t;
+
+typedef struct {
+    pool_slot_t apps[POOL_MAX_APPS];
+    uint32_t app_count;
+    uint32_t pending; // over all apps and the scratchpad, 0 skips lookups
+
+    xcb_window_t scratch; // XCB_NONE until the first toggle maps it
+    uint8_t scratch_pending;
+    uint64_t scratch_started_ms;
+} pool_t;
+
+void pool_init(struct qwm_t *wm);
+
+// kills parked windows, they would outlive us invisible otherwise
+void pool_kill(struct qwm_t *wm);
+
+// returns 1 when win was one of ours and got parked or adopted
+int32_t pool_map_request(struct qwm_t *wm, xcb_window_t win);
+
+// returns 1 when win was parked, it never was a client then
+int32_t pool_forget(struct qwm_t *wm, xcb_window_t win);
+
+#endif // POOL_H
@@ -6,10 +6,12 @@
 #include <stdlib.h>
 #include <sys/wait.h> // waitpid, sigemptyset, sigaction, SA_RESTART, SA_NOCLDSTOP
 #include <unistd.h> // fork, setsid, execlp, _exit
-#include <poll.h>   // struct pollfd, POLL_IN
+#include <poll.h>   // struct pollfd, POLLIN
 
 #include <xcb/xcb_keysyms.h>
 
+#define QWM_MAX_POLLFD 16
+
 static void handle_child_signal(int sig)
 {
     (void)sig;
@@ -26,7 +28,8 @@ static void kill_client_window(struct qwm_t *wm, xcb_window_t win)
 static void move_to_new_ws(qwm_t *wm, client_t *c, uint16_t dst)
 {
     if (!wm || !c) return;
-    if (dst >= WORKSPACE_COUNT) return;
+    if (dst >= WORKSPACE_TOTAL) return;
+    if (!monitor_of_ws(wm, dst)->active) return;
 
     uint16_t src = c->workspace;
     if (src == dst) return;
@@ -34,6 +37,9 @@ static void move_to_new_ws(qwm_t *wm, client_t *c, uint16_t dst)
     workspace_t *ws_src = &wm->workspaces[src];
     workspace_t *ws_dst = &wm->workspaces[dst];
 
+    // dst places it again on its own grid
+    place_remove(wm, c);
+
     client_t **pc = &ws_src->clients;
     while (*pc)
     {
@@ -45,7 +51,22 @@ static void move_to_new_ws(qwm_t *wm, client_t *c, uint16_t dst)
         pc = &(*pc)->next;
     }
 
-    if (ws_src->focused == c) ws_src->focused = ws_src->clients;
+    if (ws_src->focused == c)
+    {
+        ws_src->focused = ws_src->clients;
+        if (src == wm->current_ws)
+        {
+            xcb_window_t next = XCB_NONE;
+            if (ws_src->focused)
+            {
+                client_set_focus(wm, ws_src->focused, 1);
+                next = ws_src->focused->win;
+                xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT,
+                                    next, XCB_CURRENT_TIME);
+            }
+            ewmh_set_active(wm, next);
+        }
+    }
 
     // insert into destination list (head)
     c->next = ws_dst->clients;
@@ -53,8 +74,10 @@ static void move_to_new_ws(qwm_t *wm, client_t *c, uint16_t dst)
     ws_dst->focused = c;
 
     c->workspace = dst;
+    ewmh_set_client_desktop(wm, c);
 
-    if (wm->current_ws != dst) xcb_unmap_window(wm->conn, c->win);
+    // dst may be showing on another output
+    if (!monitor_ws_visible(wm, dst)) client_show(wm, c, 0);
 
     layout_apply(wm, src);
     layout_apply(wm, dst);
@@ -70,31 +93,50 @@ static void move_focused_to_ws(qwm_t *wm, uint16_t ws)
     move_to_new_ws(wm, w->focused, ws);
 }
 
+static void focus_current_ws(qwm_t *wm)
+{
+    workspace_t *cur = &wm->workspaces[wm->current_ws];
+
+    xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT,
+                        cur->focused ? cur->focused->win : wm->root,
+                        XCB_CURRENT_TIME);
+
+    ewmh_set_current_desktop(wm);
+    ewmh_set_active(wm, cur->focused ? cur->focused->win : XCB_NONE);
+}
+
 static void workspace_switch(qwm_t *wm, uint16_t new_ws)
 {
     if (!wm) return;
-    if (new_ws < 0 || new_ws >= WORKSPACE_COUNT) return;
+    if (new_ws >= WORKSPACE_TOTAL) return;
     if (new_ws == wm->current_ws) return;
 
-    // hide old workspace
-    workspace_t *old = &wm->workspaces[wm->current_ws];
-    for (client_t *c = old->clients; c; c = c->next)
-        xcb_unmap_window(wm->conn, c->win);
+    monitor_t *mon = monitor_of_ws(wm, new_ws);
+    if (!mon->active) return;
 
-    wm->current_ws = (uint16_t)new_ws;
-
-    // show new workspace
-    workspace_t *cur = &wm->workspaces[wm->current_ws];
-    for (client_t *c = cur->clients; c; c = c->next)
+    if (mon->cur_ws != new_ws)
     {
-        xcb_map_window(wm->conn, c->win);
-    }
+        // hide old workspace
+        workspace_t *old = &wm->workspaces[mon->cur_ws];
+        for (client_t *c = old->clients; c; c = c->next)
+            client_show(wm, c, 0);
 
-    if (cur->focused)
-    {
-        xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT,
-                            cur->focused->win, XCB_CURRENT_TIME);
+        mon->cur_ws = new_ws;
+
+        // show new workspace, the layout decides which clients get mapped
+        layout_apply(wm, new_ws);
     }
+
+    wm->current_mon = WS_MONITOR(new_ws);
+    wm->current_ws = new_ws;
+
+    focus_current_ws(wm);
+}
+
+// workspace_N and move_to_workspace_N are relative to the focused output
+static uint16_t ws_on_current_mon(qwm_t *wm, uint16_t n)
+{
+    return (uint16_t)(wm->current_mon * WORKSPACE_COUNT + n);
 }
 
 /*****************************
@@ -237,6 +279,9 @@ void focus_next(struct qwm_t *wm)
     ws->focused = next;
     client_set_focus(wm, ws->focused, 1);
 
+    // may flip the stack page, focus needs the window mapped
+    layout_apply(wm, wm->current_ws);
+
     xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT, next->win,
                         XCB_CURRENT_TIME);
 
@@ -270,6 +315,9 @@ void focus_prev(struct qwm_t *wm)
     ws->focused = prev;
     client_set_focus(wm, ws->focused, 1);
 
+    // may flip the stack page, focus needs the window mapped
+    layout_apply(wm, wm->current_ws);
+
     xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT, prev->win,
                         XCB_CURRENT_TIME);
 
@@ -301,47 +349,164 @@ void swap_master(struct qwm_t *wm)
     layout_apply(wm, wm->current_ws);
 }
 
-void workspace_1(struct qwm_t *qwm) { workspace_switch(qwm, 0); }
-void workspace_2(struct qwm_t *qwm) { workspace_switch(qwm, 1); }
-void workspace_3(struct qwm_t *qwm) { workspace_switch(qwm, 2); }
-void workspace_4(struct qwm_t *qwm) { workspace_switch(qwm, 3); }
-void workspace_5(struct qwm_t *qwm) { workspace_switch(qwm, 4); }
+// clang-format off
+void workspace_1(struct qwm_t *qwm) { workspace_switch(qwm, ws_on_current_mon(qwm, 0)); }
+void workspace_2(struct qwm_t *qwm) { workspace_switch(qwm, ws_on_current_mon(qwm, 1)); }
+void workspace_3(struct qwm_t *qwm) { workspace_switch(qwm, ws_on_current_mon(qwm, 2)); }
+void workspace_4(struct qwm_t *qwm) { workspace_switch(qwm, ws_on_current_mon(qwm, 3)); }
+void workspace_5(struct qwm_t *qwm) { workspace_switch(qwm, ws_on_current_mon(qwm, 4)); }
+
+void move_to_workspace_1(struct qwm_t *qwm) { move_focused_to_ws(qwm, ws_on_current_mon(qwm, 0)); }
+void move_to_workspace_2(struct qwm_t *qwm) { move_focused_to_ws(qwm, ws_on_current_mon(qwm, 1)); }
+void move_to_workspace_3(struct qwm_t *qwm) { move_focused_to_ws(qwm, ws_on_current_mon(qwm, 2)); }
+void move_to_workspace_4(struct qwm_t *qwm) { move_focused_to_ws(qwm, ws_on_current_mon(qwm, 3)); }
+void move_to_workspace_5(struct qwm_t *qwm) { move_focused_to_ws(qwm, ws_on_current_mon(qwm, 4)); }
+// clang-format on
+
+void focus_next_monitor(struct qwm_t *wm)
+{
+    monitor_t *next = monitor_next(wm, wm->current_mon);
+    if (next == &wm->monitors[wm->current_mon]) return;
+
+    wm->current_mon = (uint16_t)(next - wm->monitors);
+    wm->current_ws = next->cur_ws;
+    focus_current_ws(wm);
+
+    // focus follows mouse, so the pointer has to come along
+    xcb_warp_pointer(wm->conn, XCB_NONE, wm->root, 0, 0, 0, 0,
+                     (int16_t)(next->x + next->w / 2),
+                     (int16_t)(next->y + next->h / 2));
+}
+
+void move_to_next_monitor(struct qwm_t *wm)
+{
+    workspace_t *w = &wm->workspaces[wm->current_ws];
+    if (!w->focused) return;
+
+    monitor_t *next = monitor_next(wm, wm->current_mon);
+    if (next == &wm->monitors[wm->current_mon]) return;
+
+    move_to_new_ws(wm, w->focused, next->cur_ws);
+}
+
+client_t *qwm_manage(qwm_t *wm, xcb_window_t win, uint16_t ws_idx,
+                     uint8_t floating, uint8_t focus)
+{
+    workspace_t *ws = &wm->workspaces[ws_idx];
+    client_t *c = client_init(wm, win, ws_idx);
+    if (!c) return NULL;
+    c->floating = floating;
+
+    int32_t take_focus = focus || !ws->focused;
+    if (take_focus)
+    {
+        if (ws->focused) client_set_focus(wm, ws->focused, 0);
+        ws->focused = c;
+    }
+    client_set_focus(wm, c, take_focus);
+
+    layout_apply(wm, ws_idx);
+
+    if (take_focus && ws_idx == wm->current_ws)
+    {
+        xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT, win,
+                            XCB_CURRENT_TIME);
+    }
+    return c;
+}
+
+void qwm_unmanage(qwm_t *wm, client_t *c)
+{
+    uint16_t ws = c->workspace;
+    workspace_t *w = &wm->workspaces[ws];
+
+    client_t **pc = &w->clients;
+    while (*pc && *pc != c) pc = &(*pc)->next;
+    if (*pc) *pc = c->next;
+
+    int32_t was_focused = (w->focused == c);
+    client_kill(wm, c);
+
+    // update focus if this was focused
+    if (was_focused)
+    {
+        w->focused = w->clients;
+        if (w->focused) client_set_focus(wm, w->focused, 1);
+    }
 
-void move_to_workspace_1(struct qwm_t *qwm) { move_focused_to_ws(qwm, 0); }
-void move_to_workspace_2(struct qwm_t *qwm) { move_focused_to_ws(qwm, 1); }
-void move_to_workspace_3(struct qwm_t *qwm) { move_focused_to_ws(qwm, 2); }
-void move_to_workspace_4(struct qwm_t *qwm) { move_focused_to_ws(qwm, 3); }
-void move_to_workspace_5(struct qwm_t *qwm) { move_focused_to_ws(qwm, 4); }
+    layout_apply(wm, ws);
+
+    if (was_focused && w->focused)
+    {
+        xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT,
+                            w->focused->win, XCB_CURRENT_TIME);
+    }
+}
 
 static void handle_map_request(qwm_t *wm, xcb_map_request_event_t *ev)
 {
-    workspace_t *ws = &wm->workspaces[wm->current_ws];
-    client_t *c = client_init(wm, ev->window);
+    // already ours, e.g. a client re-mapping itself after withdrawing
+    client_t *known = client_find(wm, ev->window);
+    if (known)
+    {
+        if (known->mapped) xcb_map_window(wm->conn, known->win);
+        return;
+    }
 
-    if (ws->focused) client_set_focus(wm, ws->focused, 0);
-    ws->focused = c;
-    client_set_focus(wm, c, 1);
+    // pre-started pool instances and the scratchpad
+    if (pool_map_request(wm, ev->window))
+    {
+        xcb_flush(wm->conn);
+        return;
+    }
 
-    xcb_map_window(wm->conn, ev->window);
+    // rules decide the workspace before anything gets mapped
+    rule_result_t rule;
+    rules_apply(wm, ev->window, &rule);
 
-    layout_apply(wm, wm->current_ws);
+    client_t *c = qwm_manage(wm, ev->window, rule.workspace, rule.floating,
+                             rule.focus);
 
     // client_add_overlay(wm, c);
 
-    xcb_set_input_focus(wm->conn, XCB_INPUT_FOCUS_POINTER_ROOT, ev->window,
-                        XCB_CURRENT_TIME);
+    if (c && c->floating)
+    {
+        uint32_t v[] = {XCB_STACK_MODE_ABOVE};
+        xcb_configure_window(wm->conn, c->win, XCB_CONFIG_WINDOW_STACK_MODE,
+                             v);
+    }
 
     xcb_flush(wm->conn);
 }
 
 static void handle_enter_notify(qwm_t *wm, xcb_enter_notify_event_t *ev)
 {
-    workspace_t *w = &wm->workspaces[wm->current_ws];
-
-    for (client_t *c = w->clients; c; c = c->next)
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
     {
-        if (c->win == ev->event)
+        monitor_t *mon = &wm->monitors[m];
+        if (!mon->active) continue;
+
+        workspace_t *w = &wm->workspaces[mon->cur_ws];
+        for (client_t *c = w->clients; c; c = c->next)
         {
+            if (c->win != ev->event) continue;
+
+            // the pointer crossed onto another output
+            if (m != wm->current_mon)
+            {
+                wm->current_mon = m;
+                wm->current_ws = mon->cur_ws;
+                ewmh_set_current_desktop(wm);
+
+                if (w->focused == c)
+                {
+                    xcb_set_input_focus(wm->conn,
+                                        XCB_INPUT_FOCUS_POINTER_ROOT, c->win,
+                                        XCB_CURRENT_TIME);
+                    ewmh_set_active(wm, c->win);
+                }
+            }
+
             if (w->focused == c) return;
             if (w->focused) client_set_focus(wm, w->focused, 0);
 
@@ -363,45 +528,16 @@ static void handle_enter_notify(qwm_t *wm, xcb_enter_notify_event_t *ev)
 
 static void handle_destroy_notify(qwm_t *wm, xcb_destroy_notify_event_t *ev)
 {
-    for (uint16_t ws = 0; ws < WORKSPACE_COUNT; ws++)
-    {
-        workspace_t *w = &wm->workspaces[ws];
-        client_t **pc = &wm->workspaces[ws].clients;
-        while (*pc)
-        {
-            client_t *c = *pc;
-            if (c->win == ev->window)
-            {
-                *pc = c->next;
+    // parked pool windows never were clients
+    if (pool_forget(wm, ev->window)) return;
 
-                int32_t was_focused = (w->focused == c);
-                client_kill(wm, c);
-
-                // update focus if this was focused
-                if (was_focused)
-                {
-                    w->focused = w->clients;
-
-                    if (w->focused)
-                    {
-                        client_set_focus(wm, w->focused, 1);
-                        xcb_set_input_focus(wm->conn,
-                                            XCB_INPUT_FOCUS_POINTER_ROOT,
-                                            w->focused->win, XCB_CURRENT_TIME);
-                    }
-                }
-
-                layout_apply(wm, ws);
-                return;
-            }
-            pc = &c->next;
-        }
-    }
+    client_t *c = client_find(wm, ev->window);
+    if (c) qwm_unmanage(wm, c);
 }
 
 static int32_t allow_configure(qwm_t *wm, xcb_window_t win)
 {
-    for (uint16_t ws = 0; ws < WORKSPACE_COUNT; ws++)
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ws++)
     {
         workspace_t *w = &wm->workspaces[ws];
         for (client_t *c = w->clients; c; c = c->next)
@@ -416,10 +552,17 @@ static void handle_configure_request(qwm_t *wm,
                                      xcb_configure_request_event_t *ev)
 {
     if (ev->window == wm->root) return;
-    if (ev->window == wm->taskbar.win) return;
+    if (monitor_bar_of(wm, ev->window)) return;
 
     if (!allow_configure(wm, ev->window)) return;
 
+    client_t *c = client_find(wm, ev->window);
+    monitor_t *m = c ? monitor_of_ws(wm, c->workspace)
+                     : &wm->monitors[wm->current_mon];
+
+    // the layout owns fullscreen geometry
+    if (c && c->fullscreen) return;
+
     uint32_t values[7];
     uint16_t mask = 0;
     uint32_t i = 0;
@@ -429,11 +572,11 @@ static void handle_configure_request(qwm_t *wm,
     int32_t w = ev->width;
     int32_t h = ev->height;
 
-    int32_t max_x = wm->w - w - 2 * BORDER_WIDTH;
-    int32_t max_y = wm->h - wm->taskbar.height - h - 2 * BORDER_WIDTH;
+    int32_t max_x = m->x + m->w - w - 2 * BORDER_WIDTH;
+    int32_t max_y = m->y + m->h - m->taskbar.height - h - 2 * BORDER_WIDTH;
 
-    if (x < 0) x = 0;
-    if (y < 0) y = 0;
+    if (x < m->x) x = m->x;
+    if (y < m->y) y = m->y;
     if (x > max_x) x = max_x;
     if (y > max_y) y = max_y;
 
@@ -470,10 +613,50 @@ static void handle_configure_request(qwm_t *wm,
         values[i++] = ev->stack_mode;
     }
 
+    // keep the layout diff in sync with what the window really has
+    if (c)
+    {
+        if (mask & XCB_CONFIG_WINDOW_X) c->x = (uint32_t)x;
+        if (mask & XCB_CONFIG_WINDOW_Y) c->y = (uint32_t)y;
+        if (mask & XCB_CONFIG_WINDOW_WIDTH) c->w = c->sent_w = (uint32_t)w;
+        if (mask & XCB_CONFIG_WINDOW_HEIGHT) c->h = c->sent_h = (uint32_t)h;
+
+        // the next floating layout honours the request too
+        if (mask & XCB_CONFIG_WINDOW_WIDTH) c->fw = (uint32_t)w;
+        if (mask & XCB_CONFIG_WINDOW_HEIGHT) c->fh = (uint32_t)h;
+        if (c->floating || wm->workspaces[c->workspace].type == LAYOUT_FLOAT)
+        {
+            if (mask & XCB_CONFIG_WINDOW_X) c->fx = (uint32_t)x;
+            if (mask & XCB_CONFIG_WINDOW_Y) c->fy = (uint32_t)y;
+            place_update(wm, c);
+        }
+    }
+
     if (mask)
         xcb_configure_window(wm->conn, ev->window, ev->value_mask, values);
 }
 
+// _NET_WM_STATE request: data32 = {action, prop1, prop2, source}
+static void handle_wm_state(qwm_t *wm, xcb_client_message_event_t *ev)
+{
+    enum { STATE_REMOVE, STATE_ADD, STATE_TOGGLE };
+
+    if (ev->data.data32[1] != wm->atom.net_wm_state_fullscreen &&
+        ev->data.data32[2] != wm->atom.net_wm_state_fullscreen)
+        return;
+
+    client_t *c = client_find(wm, ev->window);
+    if (!c) return;
+
+    uint32_t action = ev->data.data32[0];
+    int32_t on = action == STATE_ADD      ? 1
+                 : action == STATE_TOGGLE ? !c->fullscreen
+                                          : 0;
+
+    client_set_fullscreen(wm, c, on);
+    layout_apply(wm, c->workspace);
+}
+
 static void handle_event(qwm_t *qwm, xcb_generic_event_t *event)
 {
     uint8_t type = event->response_type & ~0x80;
@@ -482,11 +665,13 @@ static void handle_event(qwm_t *qwm, xcb_generic_event_t *event)
     {
     case XCB_EXPOSE:
     {
-        if (qwm->launcher.opened)
+        xcb_expose_event_t *eev = (xcb_expose_event_t *)event;
+        taskbar_t *tb = monitor_bar_of(qwm, eev->window);
+
+        if (tb)
+            taskbar_handle_expose(qwm, tb, eev);
+        else if (qwm->launcher.opened)
             launcher_draw(qwm, &qwm->launcher);
-        else
-            taskbar_handle_expose(qwm, &qwm->taskbar,
-                                  (xcb_expose_event_t *)event);
     }
     break;
     case XCB_CLIENT_MESSAGE:
@@ -499,6 +684,10 @@ static void handle_event(qwm_t *qwm, xcb_generic_event_t *event)
                 xcb_destroy_window(qwm->conn, cev->window);
             }
         }
+        else if (cev->type == qwm->atom.net_wm_state)
+        {
+            handle_wm_state(qwm, cev);
+        }
     }
     break;
     case XCB_MAP_REQUEST:
@@ -510,9 +699,30 @@ static void handle_event(qwm_t *qwm, xcb_generic_event_t *event)
     case XCB_ENTER_NOTIFY:
         handle_enter_notify(qwm, (xcb_enter_notify_event_t *)event);
         break;
+    case XCB_PROPERTY_NOTIFY:
+    {
+        xcb_property_notify_event_t *pev =
+            (xcb_property_notify_event_t *)event;
+        if (pev->atom != qwm->atom.net_wm_name &&
+            pev->atom != XCB_ATOM_WM_NAME)
+            break;
+
+        client_t *c = client_find(qwm, pev->window);
+        if (c) client_title_stale(qwm, c);
+    }
+    break;
     case XCB_DESTROY_NOTIFY:
         handle_destroy_notify(qwm, (xcb_destroy_notify_event_t *)event);
         break;
+    case XCB_BUTTON_PRESS:
+        drag_start(qwm, (xcb_button_press_event_t *)event);
+        break;
+    case XCB_MOTION_NOTIFY:
+        drag_motion(qwm, (xcb_motion_notify_event_t *)event);
+        break;
+    case XCB_BUTTON_RELEASE:
+        drag_end(qwm, (xcb_button_release_event_t *)event);
+        break;
     case XCB_KEY_PRESS:
     {
         xcb_key_press_event_t *kev = (xcb_key_press_event_t *)event;
@@ -529,16 +739,42 @@ static void handle_event(qwm_t *qwm, xcb_generic_event_t *event)
             if (kev->detail == qwm->keybinds[i].key &&
                 (state == qwm->keybinds[i].mod))
             {
-                qwm->keybinds[i].func(qwm);
+                rcfile_run_bind(qwm, &qwm->rc, (uint32_t)i);
                 break;
             }
         }
         break;
     }
 
-    default: break;
+    default:
+        if (qwm->randr_event_base &&
+            type == qwm->randr_event_base + XCB_RANDR_SCREEN_CHANGE_NOTIFY)
+        {
+            xcb_randr_screen_change_notify_event_t *rev =
+                (xcb_randr_screen_change_notify_event_t *)event;
+            qwm->w = rev->width;
+            qwm->h = rev->height;
+            monitor_update(qwm);
+        }
+        else if (qwm->sync_event_base &&
+            type == qwm->sync_event_base + XCB_SYNC_ALARM_NOTIFY)
+        {
+            client_sync_notify(qwm, (xcb_sync_alarm_notify_event_t *)event);
+        }
+        else if (qwm->shm_event_base && type == qwm->shm_event_base)
+        {
+            taskbar_t *tb = monitor_bar_of(qwm, raster_completion(event));
+            if (tb) taskbar_shm_done(qwm, tb);
+        }
+        else
+        {
+            idle_event(qwm, event);
+        }
+        break;
     }
 
+    ewmh_commit(qwm);
+    ipc_notify(qwm);
     xcb_flush(qwm->conn);
 }
 
@@ -585,7 +821,7 @@ qwm_t *qwm_init(void)
     qwm->h = qwm->screen->height_in_pixels;
 
     qwm->current_ws = 0;
-    for (uint16_t i = 0; i < WORKSPACE_COUNT; ++i)
+    for (uint16_t i = 0; i < WORKSPACE_TOTAL; ++i)
     {
         qwm->workspaces[i].clients = NULL;
         qwm->workspaces[i].focused = NULL;
@@ -615,36 +851,66 @@ qwm_t *qwm_init(void)
     qwm->atom.net_wm_name = intern_atom(qwm, "_NET_WM_NAME");
     qwm->atom.net_supported = intern_atom(qwm, "_NET_SUPPORTED");
     qwm->atom.net_active_window = intern_atom(qwm, "_NET_ACTIVE_WINDOW");
+    qwm->atom.net_client_list = intern_atom(qwm, "_NET_CLIENT_LIST");
+    qwm->atom.net_current_desktop = intern_atom(qwm, "_NET_CURRENT_DESKTOP");
+    qwm->atom.net_number_of_desktops =
+        intern_atom(qwm, "_NET_NUMBER_OF_DESKTOPS");
+    qwm->atom.net_wm_desktop = intern_atom(qwm, "_NET_WM_DESKTOP");
+    qwm->atom.net_wm_sync_request = intern_atom(qwm, "_NET_WM_SYNC_REQUEST");
+    qwm->atom.net_wm_sync_request_counter =
+        intern_atom(qwm, "_NET_WM_SYNC_REQUEST_COUNTER");
+    qwm->atom.wm_state = intern_atom(qwm, "WM_STATE");
+    qwm->atom.net_wm_state = intern_atom(qwm, "_NET_WM_STATE");
+    qwm->atom.net_wm_state_hidden = intern_atom(qwm, "_NET_WM_STATE_HIDDEN");
+    qwm->atom.net_wm_state_fullscreen =
+        intern_atom(qwm, "_NET_WM_STATE_FULLSCREEN");
 
     xcb_atom_t supported[] = {
         qwm->atom.net_supported,
         qwm->atom.net_wm_name,
         qwm->atom.net_active_window,
+        qwm->atom.net_client_list,
+        qwm->atom.net_current_desktop,
+        qwm->atom.net_number_of_desktops,
+        qwm->atom.net_wm_desktop,
+        qwm->atom.net_wm_sync_request,
+        qwm->atom.net_wm_state,
+        qwm->atom.net_wm_state_hidden,
+        qwm->atom.net_wm_state_fullscreen,
     };
 
     xcb_change_property(qwm->conn, XCB_PROP_MODE_REPLACE, qwm->root,
                         qwm->atom.net_supported, XCB_ATOM_ATOM, 32,
                         sizeof(supported) / sizeof(xcb_atom_t), supported);
 
-    // setup keybinding
-    qwm->keybinds = my_keybinds;
-    qwm->keybind_count = sizeof(my_keybinds) / sizeof(my_keybinds[0]);
-    static const uint16_t lock_masks[] = {0, XCB_MOD_MASK_LOCK, XCB_MOD_MASK_2,
-                                          XCB_MOD_MASK_LOCK | XCB_MOD_MASK_2};
+    ewmh_init(qwm, &qwm->ewmh);
 
-    for (size_t i = 0; i < sizeof(my_keybinds) / sizeof(my_keybinds[0]); ++i)
+    // XSync alarms for _NET_WM_SYNC_REQUEST, optional
+    const xcb_query_extension_reply_t *sync_ext =
+        xcb_get_extension_data(qwm->conn, &xcb_sync_id);
+    if (sync_ext && sync_ext->present)
     {
-        for (size_t j = 0; j < 4; ++j)
-        {
-            xcb_grab_key(
-                qwm->conn, 1, qwm->root, my_keybinds[i].mod | lock_masks[j],
-                my_keybinds[i].key, XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC);
-        }
+        xcb_sync_initialize_reply_t *sync_rep = xcb_sync_initialize_reply(
+            qwm->conn, xcb_sync_initialize(qwm->conn, 3, 1), NULL);
+        if (sync_rep) qwm->sync_event_base = sync_ext->first_event;
+        free(sync_rep);
     }
 
-    taskbar_init(qwm, &qwm->taskbar);
+    // setup keybinding, colors and runtime overrides
+    rcfile_init(qwm, &qwm->rc);
+    rcfile_apply(qwm, &qwm->rc);
+
+    font_open(qwm, &qwm->font, FONT);
+    raster_setup(qwm);
+    monitor_init(qwm);
+    drag_init(qwm);
+    idle_init(qwm);
+    rules_init(&qwm->rules);
+    pool_init(qwm);
     tray_init(&qwm->tray);
+    netlink_init(qwm);
     launcher_init(&qwm->launcher);
+    ipc_init(qwm);
 
     xcb_flush(qwm->conn);
 
@@ -660,8 +926,49 @@ void qwm_run(qwm_t *qwm)
 
     while (!xcb_connection_has_error(qwm->conn))
     {
-        struct pollfd pfd = {.fd = xfd, .events = POLL_IN};
-        poll(&pfd, 1, 1000);
+        struct pollfd pfd[QWM_MAX_POLLFD];
+        nfds_t nfd = 0;
+
+        pfd[nfd++] = (struct pollfd){.fd = xfd, .events = POLLIN};
+
+        nfds_t rc_idx = nfd;
+        if (qwm->rc.inotify_fd >= 0)
+            pfd[nfd++] = (struct pollfd){.fd = qwm->rc.inotify_fd,
+                                         .events = POLLIN};
+
+        nfds_t net_idx = nfd;
+        if (qwm->net.fd >= 0)
+            pfd[nfd++] = (struct pollfd){.fd = qwm->net.fd, .events = POLLIN};
+
+        nfds_t tray_idx = nfd;
+        if (qwm->tray.worker.running)
+            pfd[nfd++] = (struct pollfd){.fd = qwm->tray.worker.wake_fd,
+                                         .events = POLLIN};
+
+        nfds_t ipc_idx = nfd;
+        nfd += ipc_pollfds(qwm, pfd + nfd, QWM_MAX_POLLFD - nfd);
+
+        // blanked: no tick at all, only X events and ipc wake us up
+        int timeout = drag_timeout(qwm);
+        if (idle_paused(&qwm->idle))
+            timeout = qwm->drag.c ? timeout : -1;
+        else
+            timeout = client_title_timeout(qwm, timeout);
+        // a stalled sync wait holds back the next configure, even blanked
+        timeout = client_sync_timeout(qwm, timeout);
+
+        poll(pfd, nfd, timeout);
+
+        if (rc_idx < net_idx && (pfd[rc_idx].revents & POLLIN))
+            dirty |= rcfile_handle_event(qwm, &qwm->rc);
+
+        if (net_idx < tray_idx && (pfd[net_idx].revents & POLLIN))
+            dirty |= netlink_handle(qwm);
+
+        if (tray_idx < ipc_idx && (pfd[tray_idx].revents & POLLIN))
+            dirty |= tray_collect(&qwm->tray);
+
+        dirty |= ipc_handle(qwm, pfd + ipc_idx, nfd - ipc_idx);
 
         xcb_generic_event_t *ev;
         while ((ev = xcb_poll_for_event(qwm->conn)))
@@ -670,12 +977,37 @@ void qwm_run(qwm_t *qwm)
             free(ev);
         }
 
-        dirty |= tray_update(qwm, &qwm->tray);
+        // one configure per drained batch, at most one per frame
+        drag_flush(qwm);
+        client_sync_expire(qwm);
+
+        // titles stay stale and the tray unread until the screen is back
+        if (idle_paused(&qwm->idle))
+        {
+            tray_pause(&qwm->tray, 1);
+            xcb_flush(qwm->conn);
+            continue;
+        }
+        dirty |= idle_woke(&qwm->idle);
+        dirty |= client_title_poll(qwm);
+
+        // tray polling only feeds the bars, nothing to do when all are
+        // under fullscreen clients
+        uint16_t shown = monitor_sync_bars(qwm);
+        tray_pause(&qwm->tray, !shown);
+        if (shown) dirty |= tray_update(qwm, &qwm->tray);
+
         if (dirty)
         {
-            taskbar_draw(qwm, &qwm->taskbar, &qwm->tray);
+            for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+            {
+                if (qwm->monitors[m].active)
+                    taskbar_draw(qwm, &qwm->monitors[m].taskbar, &qwm->tray);
+            }
             dirty = 0;
         }
+
+        xcb_flush(qwm->conn);
     }
 
     fprintf(stderr, "X connection closed\n");
@@ -686,7 +1018,16 @@ void qwm_kill(qwm_t *qwm)
     if (!qwm) return;
 
     launcher_kill(&qwm->launcher);
-    taskbar_kill(qwm, &qwm->taskbar);
+    rcfile_kill(&qwm->rc);
+    ipc_kill(qwm);
+    netlink_kill(qwm);
+    tray_kill(&qwm->tray);
+    ewmh_kill(&qwm->ewmh);
+    layout_kill(qwm);
+    rules_kill(&qwm->rules);
+    pool_kill(qwm);
+    monitor_kill(qwm);
+    font_close(qwm, &qwm->font);
 
     if (qwm->conn) xcb_disconnect(qwm->conn);
     free(qwm);
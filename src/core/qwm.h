@@ -11,6 +11,16 @@
 #include "views.h"
 #include "tray_status.h"
 #include "launcher.h"
+#include "rcfile.h"
+#include "ipc.h"
+#include "ewmh.h"
+#include "monitor.h"
+#include "drag.h"
+#include "rules.h"
+#include "pool.h"
+#include "font.h"
+#include "idle.h"
+#include "netlink.h"
 
 typedef struct qwm_t qwm_t;
 
@@ -22,6 +32,16 @@ typedef struct {
     xcb_atom_t net_wm_name;
     xcb_atom_t net_supported;
     xcb_atom_t net_active_window;
+    xcb_atom_t net_client_list;
+    xcb_atom_t net_current_desktop;
+    xcb_atom_t net_number_of_desktops;
+    xcb_atom_t net_wm_desktop;
+    xcb_atom_t net_wm_sync_request;
+    xcb_atom_t net_wm_sync_request_counter;
+    xcb_atom_t wm_state;
+    xcb_atom_t net_wm_state;
+    xcb_atom_t net_wm_state_hidden;
+    xcb_atom_t net_wm_state_fullscreen;
 } atom_t;
 
 struct qwm_t {
@@ -33,16 +53,41 @@ struct qwm_t {
     xcb_screen_t *screen;
 
     atom_t atom;
+    font_t font; // bars and launcher
+    uint8_t sync_event_base;  // 0 without the XSync extension
+    uint8_t randr_event_base; // 0 without RandR 1.3
+    uint8_t shm_event_base;   // 0 without MIT-SHM or USE_SHM_BAR
 
-    taskbar_t taskbar;
     tray_status_t tray;
     launcher_t launcher;
+    ewmh_t ewmh;
+    rcfile_t rc;
+    drag_t drag;
+    rules_t rules;
+    pool_t pool;
+    idle_t idle;
+    netlink_t net; // feeds tray.connection
+#if USE_IPC
+    ipc_t ipc;
+#endif
 
     const keybind_t *keybinds;
     uint64_t keybind_count;
 
-    workspace_t workspaces[WORKSPACE_COUNT];
+    // clients we manage vs. clients we keep mapped, see client_show
+    uint32_t managed_count;
+    uint32_t mapped_count;
+
+    monitor_t monitors[MAX_MONITORS];
+    uint16_t current_mon;
+
+    // current_ws is the visible workspace of current_mon
+    workspace_t workspaces[WORKSPACE_TOTAL];
     uint16_t current_ws;
+
+    // scratch for layout_apply, grown to the largest workspace seen
+    geom_t *layout_geom;
+    uint16_t layout_cap;
 };
 
 qwm_t *qwm_init(void);
@@ -51,4 +96,11 @@ void qwm_run(qwm_t *qwm);
 
 void qwm_kill(qwm_t *qwm);
 
+// manage win on ws and relayout it, shared by MapRequest and the pool
+client_t *qwm_manage(qwm_t *wm, xcb_window_t win, uint16_t ws,
+                     uint8_t floating, uint8_t focus);
+
+// forget c and free it without touching the window, refocuses its ws
+void qwm_unmanage(qwm_t *wm, client_t *c);
+
 #endif // QUIET_WM_H
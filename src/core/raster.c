@@ -0,0 +1,338 @@
+#include "qwm.h"
+#include "raster.h"
+
+#if USE_SHM_BAR
+
+#    include <stdlib.h>
+#    include <string.h>
+#    include <sys/ipc.h>
+#    include <sys/shm.h>
+
+#    include <xcb/shm.h>
+
+#    define GLYPH_W 5
+#    define GLYPH_H 9
+#    define GLYPH_ASCENT 7 // rows above the baseline, the rest descends
+#    define ADVANCE 6
+
+// printable ASCII, one byte per row, bit 4 is the leftmost column
+static const uint8_t atlas[95][GLYPH_H] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00}, // !
+    {0x0a, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a, 0x00, 0x00}, // #
+    {0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04, 0x00, 0x00}, // $
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03, 0x00, 0x00}, // %
+    {0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d, 0x00, 0x00}, // &
+    {0x04, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00, 0x00}, // (
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00, 0x00}, // )
+    {0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00, 0x00, 0x00}, // *
+    {0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00, 0x00, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08, 0x00}, // ,
+    {0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c, 0x00, 0x00}, // .
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00, 0x00}, // /
+    {0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e, 0x00, 0x00}, // 0
+    {0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e, 0x00, 0x00}, // 1
+    {0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f, 0x00, 0x00}, // 2
+    {0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e, 0x00, 0x00}, // 3
+    {0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02, 0x00, 0x00}, // 4
+    {0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e, 0x00, 0x00}, // 5
+    {0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e, 0x00, 0x00}, // 6
+    {0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08, 0x00, 0x00}, // 7
+    {0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e, 0x00, 0x00}, // 8
+    {0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c, 0x00, 0x00}, // 9
+    {0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00, 0x00, 0x00}, // :
+    {0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08, 0x00, 0x00}, // ;
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00}, // <
+    {0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00}, // =
+    {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00, 0x00}, // >
+    {0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04, 0x00, 0x00}, // ?
+    {0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e, 0x00, 0x00}, // @
+    {0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11, 0x00, 0x00}, // A
+    {0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e, 0x00, 0x00}, // B
+    {0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e, 0x00, 0x00}, // C
+    {0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c, 0x00, 0x00}, // D
+    {0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f, 0x00, 0x00}, // E
+    {0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10, 0x00, 0x00}, // F
+    {0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f, 0x00, 0x00}, // G
+    {0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11, 0x00, 0x00}, // H
+    {0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e, 0x00, 0x00}, // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c, 0x00, 0x00}, // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11, 0x00, 0x00}, // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f, 0x00, 0x00}, // L
+    {0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00, 0x00}, // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11, 0x00, 0x00}, // N
+    {0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00, 0x00}, // O
+    {0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10, 0x00, 0x00}, // P
+    {0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d, 0x00, 0x00}, // Q
+    {0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11, 0x00, 0x00}, // R
+    {0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e, 0x00, 0x00}, // S
+    {0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00}, // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00, 0x00}, // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04, 0x00, 0x00}, // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a, 0x00, 0x00}, // W
+    {0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11, 0x00, 0x00}, // X
+    {0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x00, 0x00}, // Y
+    {0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f, 0x00, 0x00}, // Z
+    {0x0e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e, 0x00, 0x00}, // [
+    {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00}, // backslash
+    {0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x00, 0x00}, // ]
+    {0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x00}, // _
+    {0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // `
+    {0x00, 0x00, 0x0e, 0x01, 0x0f, 0x11, 0x0f, 0x00, 0x00}, // a
+    {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1e, 0x00, 0x00}, // b
+    {0x00, 0x00, 0x0e, 0x10, 0x10, 0x11, 0x0e, 0x00, 0x00}, // c
+    {0x01, 0x01, 0x0d, 0x13, 0x11, 0x11, 0x0f, 0x00, 0x00}, // d
+    {0x00, 0x00, 0x0e, 0x11, 0x1f, 0x10, 0x0e, 0x00, 0x00}, // e
+    {0x06, 0x09, 0x08, 0x1c, 0x08, 0x08, 0x08, 0x00, 0x00}, // f
+    {0x00, 0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x01, 0x0e}, // g
+    {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00, 0x00}, // h
+    {0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x0e, 0x00, 0x00}, // i
+    {0x02, 0x00, 0x06, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c}, // j
+    {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12, 0x00, 0x00}, // k
+    {0x0c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e, 0x00, 0x00}, // l
+    {0x00, 0x00, 0x1a, 0x15, 0x15, 0x15, 0x15, 0x00, 0x00}, // m
+    {0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00, 0x00}, // n
+    {0x00, 0x00, 0x0e, 0x11, 0x11, 0x11, 0x0e, 0x00, 0x00}, // o
+    {0x00, 0x00, 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10}, // p
+    {0x00, 0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x01, 0x01}, // q
+    {0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10, 0x00, 0x00}, // r
+    {0x00, 0x00, 0x0f, 0x10, 0x0e, 0x01, 0x1e, 0x00, 0x00}, // s
+    {0x08, 0x08, 0x1c, 0x08, 0x08, 0x09, 0x06, 0x00, 0x00}, // t
+    {0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0d, 0x00, 0x00}, // u
+    {0x00, 0x00, 0x11, 0x11, 0x11, 0x0a, 0x04, 0x00, 0x00}, // v
+    {0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0a, 0x00, 0x00}, // w
+    {0x00, 0x00, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x00, 0x00}, // x
+    {0x00, 0x00, 0x11, 0x11, 0x11, 0x0f, 0x01, 0x01, 0x0e}, // y
+    {0x00, 0x00, 0x1f, 0x02, 0x04, 0x08, 0x1f, 0x00, 0x00}, // z
+    {0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00, 0x00}, // {
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00}, // |
+    {0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00, 0x00}, // }
+    {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00, 0x00}, // ~
+};
+
+static font_t atlas_font;
+static uint8_t shm_ok;
+
+// 24 bit TrueColor, 32bpp, in our own byte order: pixels are 0xRRGGBB
+static int32_t visual_ok(struct qwm_t *wm)
+{
+    const uint16_t one = 1;
+    uint8_t lsb_host = *(const uint8_t *)&one;
+    if (wm->setup->image_byte_order !=
+        (lsb_host ? XCB_IMAGE_ORDER_LSB_FIRST : XCB_IMAGE_ORDER_MSB_FIRST))
+        return 0;
+    if (wm->screen->root_depth != 24) return 0;
+
+    int32_t bpp_ok = 0;
+    xcb_format_iterator_t f = xcb_setup_pixmap_formats_iterator(wm->setup);
+    for (; f.rem; xcb_format_next(&f))
+    {
+        if (f.data->depth == 24 && f.data->bits_per_pixel == 32) bpp_ok = 1;
+    }
+    if (!bpp_ok) return 0;
+
+    xcb_depth_iterator_t d = xcb_screen_allowed_depths_iterator(wm->screen);
+    for (; d.rem; xcb_depth_next(&d))
+    {
+        xcb_visualtype_iterator_t v = xcb_depth_visuals_iterator(d.data);
+        for (; v.rem; xcb_visualtype_next(&v))
+        {
+            if (v.data->visual_id != wm->screen->root_visual) continue;
+            return v.data->_class == XCB_VISUAL_CLASS_TRUE_COLOR &&
+                   v.data->red_mask == 0xFF0000 &&
+                   v.data->green_mask == 0xFF00 && v.data->blue_mask == 0xFF;
+        }
+    }
+    return 0;
+}
+
+static int32_t shm_alloc(struct qwm_t *wm, raster_t *r, size_t size)
+{
+    int id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (id < 0) return 0;
+
+    void *mem = shmat(id, NULL, 0);
+    if (mem == (void *)-1)
+    {
+        shmctl(id, IPC_RMID, NULL);
+        return 0;
+    }
+
+    // the server has attached once the checked request returns, so the
+    // id can be removed now and the segment dies with its last user
+    r->shmseg = xcb_generate_id(wm->conn);
+    xcb_void_cookie_t ck =
+        xcb_shm_attach_checked(wm->conn, r->shmseg, (uint32_t)id, 1);
+    xcb_generic_error_t *err = xcb_request_check(wm->conn, ck);
+    shmctl(id, IPC_RMID, NULL);
+
+    if (err)
+    {
+        free(err);
+        shmdt(mem);
+        r->shmseg = 0;
+        return 0;
+    }
+
+    r->pixels = mem;
+    return 1;
+}
+
+/*****************************
+ * RASTER
+ *****************************/
+
+void raster_setup(struct qwm_t *wm)
+{
+    for (uint32_t c = 0; c < 256; ++c) atlas_font.width[c] = ADVANCE;
+    atlas_font.ascent = GLYPH_ASCENT;
+    atlas_font.descent = GLYPH_H - GLYPH_ASCENT;
+
+    const xcb_query_extension_reply_t *ext =
+        xcb_get_extension_data(wm->conn, &xcb_shm_id);
+    if (!ext || !ext->present) return;
+
+    xcb_shm_query_version_reply_t *ver = xcb_shm_query_version_reply(
+        wm->conn, xcb_shm_query_version(wm->conn), NULL);
+    if (ver)
+    {
+        shm_ok = 1;
+        wm->shm_event_base = ext->first_event;
+    }
+    free(ver);
+}
+
+int32_t raster_init(struct qwm_t *wm, raster_t *r, uint16_t w, uint16_t h)
+{
+    memset(r, 0, sizeof(*r));
+    if (!w || !h || !visual_ok(wm)) return 0;
+
+    size_t size = (size_t)w * h * sizeof(uint32_t);
+    if (!shm_ok || !shm_alloc(wm, r, size))
+    {
+        r->pixels = malloc(size);
+        if (!r->pixels) return 0;
+    }
+
+    r->w = w;
+    r->h = h;
+    return 1;
+}
+
+void raster_kill(struct qwm_t *wm, raster_t *r)
+{
+    if (!r->pixels) return;
+
+    if (r->shmseg)
+    {
+        xcb_shm_detach(wm->conn, r->shmseg);
+        shmdt(r->pixels);
+    }
+    else
+    {
+        free(r->pixels);
+    }
+    memset(r, 0, sizeof(*r));
+}
+
+const font_t *raster_font(void) { return &atlas_font; }
+
+void raster_fill(raster_t *r, int32_t x, int32_t y, int32_t w, int32_t h,
+                 uint32_t color)
+{
+    if (x < 0) w += x, x = 0;
+    if (y < 0) h += y, y = 0;
+    if (x + w > r->w) w = r->w - x;
+    if (y + h > r->h) h = r->h - y;
+    if (w <= 0 || h <= 0) return;
+
+    // plain span stores, vectorized by the compiler
+    for (int32_t row = y; row < y + h; ++row)
+    {
+        uint32_t *p = r->pixels + (size_t)row * r->w + x;
+        for (int32_t i = 0; i < w; ++i) p[i] = color;
+    }
+}
+
+void raster_text(raster_t *r, int32_t x, int32_t baseline, const char *s,
+                 uint32_t len, uint32_t color)
+{
+    int32_t top = baseline - GLYPH_ASCENT;
+
+    for (uint32_t i = 0; i < len; ++i, x += ADVANCE)
+    {
+        uint8_t c = (uint8_t)s[i];
+        if (c < 32 || c > 126) c = '?';
+        if (x < 0 || x + GLYPH_W > r->w) continue;
+
+        const uint8_t *g = atlas[c - 32];
+        for (int32_t row = 0; row < GLYPH_H; ++row)
+        {
+            int32_t y = top + row;
+            if (y < 0 || y >= r->h || !g[row]) continue;
+
+            uint32_t *p = r->pixels + (size_t)y * r->w + x;
+            for (int32_t b = 0; b < GLYPH_W; ++b)
+            {
+                if (g[row] & (0x10 >> b)) p[b] = color;
+            }
+        }
+    }
+}
+
+// PutImage wants the rect packed, columns [x, x + w) of every row
+static void pack_span(const raster_t *r, int16_t x, uint16_t w,
+                      uint32_t *out)
+{
+    for (uint32_t y = 0; y < r->h; ++y)
+        memcpy(out + (size_t)y * w, r->pixels + (size_t)y * r->w + x, w * 4u);
+}
+
+void raster_put(struct qwm_t *wm, raster_t *r, xcb_window_t win,
+                xcb_gcontext_t gc, int16_t x, uint16_t w)
+{
+    if (x < 0) w = (uint16_t)(w + x), x = 0;
+    if (x + w > r->w) w = (uint16_t)(r->w - x);
+    if (!w) return;
+
+    if (r->shmseg)
+    {
+        // the server reads straight out of the segment
+        xcb_shm_put_image(wm->conn, win, gc, r->w, r->h, (uint16_t)x, 0, w,
+                          r->h, x, 0, 24, XCB_IMAGE_FORMAT_Z_PIXMAP, 1,
+                          r->shmseg, 0);
+        r->busy = 1;
+        return;
+    }
+
+    // one request per row band, each within the request length
+    uint32_t max = xcb_get_maximum_request_length(wm->conn) * 4 - 64;
+    uint32_t rows = max / (w * 4u);
+    if (!rows) return;
+
+    uint32_t *pack = malloc((size_t)w * r->h * 4);
+    if (!pack) return;
+    pack_span(r, x, w, pack);
+
+    for (uint32_t y = 0; y < r->h; y += rows)
+    {
+        uint32_t n = r->h - y < rows ? r->h - y : rows;
+        xcb_put_image(wm->conn, XCB_IMAGE_FORMAT_Z_PIXMAP, win, gc, w,
+                      (uint16_t)n, x, (int16_t)y, 0, 24, n * w * 4u,
+                      (const uint8_t *)(pack + (size_t)y * w));
+    }
+    free(pack);
+}
+
+void raster_done(raster_t *r) { r->busy = 0; }
+
+xcb_window_t raster_completion(xcb_generic_event_t *ev)
+{
+    return ((xcb_shm_completion_event_t *)ev)->drawable;
+}
+
+#endif // USE_SHM_BAR
@@ -0,0 +1,122 @@
+/*
+ * Client side bar rasterizer
+ * Compiled out unless USE_SHM_BAR is set in config.h.
+ *
+ * The bar is drawn into a 32bpp buffer with an embedded 5x9 bitmap font
+ * and presented with one ShmPutImage, so no pixel data crosses the
+ * socket. Without MIT-SHM (remote X) the buffer goes out with PutImage.
+ * Only 24 bit TrueColor screens are handled, raster_init fails otherwise
+ * and the bar keeps drawing with core fonts.
+ *
+ * A ShmPutImage reads the buffer after we sent it, so nothing is drawn
+ * until its completion event came back, see raster_done.
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "font.h"
+
+struct qwm_t;
+
+typedef struct {
+    uint32_t *pixels; // w * h, 0xRRGGBB
+    uint16_t w, h;
+    uint32_t shmseg; // 0 without MIT-SHM
+    uint8_t busy;    // ShmPutImage not completed yet
+} raster_t;
+
+#if USE_SHM_BAR
+
+// one time MIT-SHM probe, the completion event base goes into qwm_t
+void raster_setup(struct qwm_t *wm);
+
+// 0 when the screen can't be drawn client side
+int32_t raster_init(struct qwm_t *wm, raster_t *r, uint16_t w, uint16_t h);
+
+void raster_kill(struct qwm_t *wm, raster_t *r);
+
+// metrics of the embedded font
+const font_t *raster_font(void);
+
+void raster_fill(raster_t *r, int32_t x, int32_t y, int32_t w, int32_t h,
+                 uint32_t color);
+
+void raster_text(raster_t *r, int32_t x, int32_t baseline, const char *s,
+                 uint32_t len, uint32_t color);
+
+void raster_put(struct qwm_t *wm, raster_t *r, xcb_window_t win,
+                xcb_gcontext_t gc, int16_t x, uint16_t w);
+
+// ShmCompletion for this raster's last put
+void raster_done(raster_t *r);
+
+// window of a ShmCompletion, the only MIT-SHM event
+xcb_window_t raster_completion(xcb_generic_event_t *ev);
+
+#else
+
+static inline void raster_setup(struct qwm_t *wm) { (void)wm; }
+
+static inline int32_t raster_init(struct qwm_t *wm, raster_t *r, uint16_t w,
+                                  uint16_t h)
+{
+    (void)wm;
+    (void)r;
+    (void)w;
+    (void)h;
+    return 0;
+}
+
+static inline void raster_kill(struct qwm_t *wm, raster_t *r)
+{
+    (void)wm;
+    (void)r;
+}
+
+static inline const font_t *raster_font(void) { return NULL; }
+
+static inline void raster_fill(raster_t *r, int32_t x, int32_t y, int32_t w,
+                               int32_t h, uint32_t color)
+{
+    (void)r;
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+    (void)color;
+}
+
+static inline void raster_text(raster_t *r, int32_t x, int32_t baseline,
+                               const char *s, uint32_t len, uint32_t color)
+{
+    (void)r;
+    (void)x;
+    (void)baseline;
+    (void)s;
+    (void)len;
+    (void)color;
+}
+
+static inline void raster_put(struct qwm_t *wm, raster_t *r, xcb_window_t win,
+                              xcb_gcontext_t gc, int16_t x, uint16_t w)
+{
+    (void)wm;
+    (void)r;
+    (void)win;
+    (void)gc;
+    (void)x;
+    (void)w;
+}
+
+static inline void raster_done(raster_t *r) { (void)r; }
+
+static inline xcb_window_t raster_completion(xcb_generic_event_t *ev)
+{
+    (void)ev;
+    return XCB_NONE;
+}
+
+#endif // USE_SHM_BAR
+
+#endif // RASTER_H
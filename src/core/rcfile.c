@@ -0,0 +1,485 @@
+#include "qwm.h"
+#include "rcfile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>       // open, O_RDONLY, O_CLOEXEC
+#include <unistd.h>      // close, read
+#include <sys/mman.h>    // mmap, munmap
+#include <sys/stat.h>    // fstat
+#include <sys/inotify.h> // inotify_init1, inotify_add_watch
+
+typedef struct {
+    const char *s;
+    uint32_t len;
+} token_t;
+
+typedef struct {
+    const char *name;
+    uint32_t value;
+} name_value_t;
+
+typedef struct {
+    const char *name;
+    void (*func)(struct qwm_t *);
+} name_func_t;
+
+// clang-format off
+static const name_value_t mod_names[] = {
+    {"alt", KEY_ALT}, {"super", KEY_SUPER},
+    {"shift", KEY_SHIFT}, {"ctrl", KEY_CTRL},
+};
+
+static const name_value_t key_names[] = {
+    {"enter", KEY_ENTER}, {"escape", KEY_ESCAPE}, {"space", KEY_SPACE},
+    {"backspace", KEY_BACKSPACE}, {"up", KEY_UP}, {"down", KEY_DOWN},
+    {"minus", KEY_MINUS}, {"equal", KEY_EQUAL},
+    {"comma", KEY_COMMA}, {"period", KEY_PERIOD},
+
+    {"a", KEY_A}, {"b", KEY_B}, {"c", KEY_C}, {"d", KEY_D}, {"e", KEY_E},
+    {"f", KEY_F}, {"g", KEY_G}, {"h", KEY_H}, {"i", KEY_I}, {"j", KEY_J},
+    {"k", KEY_K}, {"l", KEY_L}, {"m", KEY_M}, {"n", KEY_N}, {"o", KEY_O},
+    {"p", KEY_P}, {"q", KEY_Q}, {"r", KEY_R}, {"s", KEY_S}, {"t", KEY_T},
+    {"u", KEY_U}, {"v", KEY_V}, {"w", KEY_W}, {"x", KEY_X}, {"y", KEY_Y},
+    {"z", KEY_Z},
+
+    {"1", KEY_1}, {"2", KEY_2}, {"3", KEY_3}, {"4", KEY_4}, {"5", KEY_5},
+    {"6", KEY_6}, {"7", KEY_7}, {"8", KEY_8}, {"9", KEY_9}, {"0", KEY_0},
+
+    {"f1", KEY_F1}, {"f2", KEY_F2}, {"f3", KEY_F3}, {"f4", KEY_F4},
+    {"f5", KEY_F5}, {"f6", KEY_F6}, {"f7", KEY_F7}, {"f8", KEY_F8},
+    {"f9", KEY_F9}, {"f10", KEY_F10}, {"f11", KEY_F11}, {"f12", KEY_F12},
+};
+
+static const name_func_t func_names[] = {
+    {"quit_wm", quit_wm},
+    {"quit_application", quit_application},
+
+    {"workspace_1", workspace_1}, {"workspace_2", workspace_2},
+    {"workspace_3", workspace_3}, {"workspace_4", workspace_4},
+    {"workspace_5", workspace_5},
+
+    {"move_to_workspace_1", move_to_workspace_1},
+    {"move_to_workspace_2", move_to_workspace_2},
+    {"move_to_workspace_3", move_to_workspace_3},
+    {"move_to_workspace_4", move_to_workspace_4},
+    {"move_to_workspace_5", move_to_workspace_5},
+
+    {"toggle_tile_orient", toggle_tile_orient},
+    {"toggle_layout", toggle_layout},
+    {"focus_next", focus_next},
+    {"focus_prev", focus_prev},
+    {"swap_master", swap_master},
+    {"focus_next_monitor", focus_next_monitor},
+    {"move_to_next_monitor", move_to_next_monitor},
+
+    {"spawn_launcher", spawn_launcher},
+    {"toggle_scratchpad", toggle_scratchpad},
+};
+// clang-format on
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+/*****************************
+ * PARSER
+ * Single pass over the mapped file, tokens are slices into it.
+ *****************************/
+
+static int32_t tok_eq(token_t t, const char *s)
+{
+    size_t n = strlen(s);
+    return t.len == n && memcmp(t.s, s, n) == 0;
+}
+
+static const char *skip_space(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+static const char *next_token(const char *p, const char *end, token_t *t)
+{
+    p = skip_space(p, end);
+    t->s = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r') p++;
+    t->len = (uint32_t)(p - t->s);
+    return p;
+}
+
+static int32_t parse_color(token_t t, uint32_t *out)
+{
+    const char *p = t.s;
+    const char *end = t.s + t.len;
+
+    if (p < end && *p == '#')
+        p++;
+    else if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+        p += 2;
+
+    if (p == end || end - p > 8) return -1;
+
+    uint32_t v = 0;
+    for (; p < end; ++p)
+    {
+        char c = *p;
+        uint32_t d;
+        if (c >= '0' && c <= '9')
+            d = (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            d = (uint32_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            d = (uint32_t)(c - 'A' + 10);
+        else
+            return -1;
+        v = (v << 4) | d;
+    }
+
+    *out = v;
+    return 0;
+}
+
+static int32_t parse_mods(token_t t, uint16_t *out)
+{
+    const char *p = t.s;
+    const char *end = t.s + t.len;
+    uint16_t mods = 0;
+
+    while (p < end)
+    {
+        token_t part = {p, 0};
+        while (p < end && *p != '+') p++;
+        part.len = (uint32_t)(p - part.s);
+        if (p < end) p++;
+
+        if (tok_eq(part, "none")) continue;
+
+        uint64_t i = 0;
+        for (; i < ARRAY_LEN(mod_names); ++i)
+        {
+            if (tok_eq(part, mod_names[i].name))
+            {
+                mods |= (uint16_t)mod_names[i].value;
+                break;
+            }
+        }
+        if (i == ARRAY_LEN(mod_names)) return -1;
+    }
+
+    *out = mods;
+    return 0;
+}
+
+static int32_t parse_key(token_t t, xcb_keycode_t *out)
+{
+    for (uint64_t i = 0; i < ARRAY_LEN(key_names); ++i)
+    {
+        if (tok_eq(t, key_names[i].name))
+        {
+            *out = (xcb_keycode_t)key_names[i].value;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int64_t find_bind(rcfile_t *rc, uint16_t mod, xcb_keycode_t key)
+{
+    for (uint32_t i = 0; i < rc->bind_count; ++i)
+    {
+        if (rc->binds[i].mod == mod && rc->binds[i].key == key) return i;
+    }
+    return -1;
+}
+
+static void remove_bind(rcfile_t *rc, uint32_t i)
+{
+    rc->bind_count--;
+    for (; i < rc->bind_count; ++i)
+    {
+        rc->binds[i] = rc->binds[i + 1];
+        memcpy(rc->cmds[i], rc->cmds[i + 1], RC_CMD_LEN);
+    }
+}
+
+static void parse_bind(rcfile_t *rc, const char *p, const char *end,
+                       int32_t unbind)
+{
+    token_t mod_tok, key_tok, act_tok;
+    p = next_token(p, end, &mod_tok);
+    p = next_token(p, end, &key_tok);
+
+    uint16_t mod;
+    xcb_keycode_t key;
+    if (parse_mods(mod_tok, &mod) < 0 || parse_key(key_tok, &key) < 0) return;
+
+    int64_t slot = find_bind(rc, mod, key);
+    if (unbind)
+    {
+        if (slot >= 0) remove_bind(rc, (uint32_t)slot);
+        return;
+    }
+
+    p = next_token(p, end, &act_tok);
+    if (!act_tok.len) return;
+
+    void (*func)(struct qwm_t *) = NULL;
+    const char *cmd = NULL;
+    uint32_t cmd_len = 0;
+
+    if (tok_eq(act_tok, "spawn"))
+    {
+        cmd = skip_space(p, end);
+        while (end > cmd && (end[-1] == ' ' || end[-1] == '\t' ||
+                             end[-1] == '\r'))
+            end--;
+        cmd_len = (uint32_t)(end - cmd);
+        if (!cmd_len || cmd_len >= RC_CMD_LEN) return;
+    }
+    else
+    {
+        for (uint64_t i = 0; i < ARRAY_LEN(func_names); ++i)
+        {
+            if (tok_eq(act_tok, func_names[i].name))
+            {
+                func = func_names[i].func;
+                break;
+            }
+        }
+        if (!func) return;
+    }
+
+    if (slot < 0)
+    {
+        if (rc->bind_count == RC_MAX_BINDS) return;
+        slot = rc->bind_count++;
+    }
+
+    rc->binds[slot].mod = mod;
+    rc->binds[slot].key = key;
+    rc->binds[slot].func = func;
+    memcpy(rc->cmds[slot], cmd ? cmd : "", cmd_len);
+    rc->cmds[slot][cmd_len] = '\0';
+}
+
+static void parse_line(rcfile_t *rc, const char *p, const char *end)
+{
+    p = skip_space(p, end);
+    if (p == end || *p == '#') return;
+
+    token_t key, val;
+    p = next_token(p, end, &key);
+
+    if (tok_eq(key, "bind"))
+    {
+        parse_bind(rc, p, end, 0);
+        return;
+    }
+    if (tok_eq(key, "unbind"))
+    {
+        parse_bind(rc, p, end, 1);
+        return;
+    }
+
+    next_token(p, end, &val);
+
+    uint32_t *dst = NULL;
+    if (tok_eq(key, "border_focus"))
+        dst = &rc->border_focus;
+    else if (tok_eq(key, "border_unfocus"))
+        dst = &rc->border_unfocus;
+    else if (tok_eq(key, "taskbar_color"))
+        dst = &rc->taskbar_color;
+    else if (tok_eq(key, "taskbar_font_color"))
+        dst = &rc->taskbar_font_color;
+    else if (tok_eq(key, "launcher_bg_color"))
+        dst = &rc->launcher_bg_color;
+    else if (tok_eq(key, "launcher_fg_color"))
+        dst = &rc->launcher_fg_color;
+    else if (tok_eq(key, "launcher_font_color"))
+        dst = &rc->launcher_font_color;
+
+    if (dst) parse_color(val, dst);
+}
+
+static void rcfile_defaults(rcfile_t *rc)
+{
+    rc->border_focus = BORDER_FOCUS;
+    rc->border_unfocus = BORDER_UNFOCUS;
+    rc->taskbar_color = TASKBAR_COLOR;
+    rc->taskbar_font_color = TASKBAR_FONT_COLOR;
+    rc->launcher_bg_color = LAUNCHER_BG_COLOR;
+    rc->launcher_fg_color = LAUNCHER_FG_COLOR;
+    rc->launcher_font_color = LAUNCHER_FONT_COLOR;
+
+    rc->bind_count = 0;
+    for (uint64_t i = 0; i < ARRAY_LEN(my_keybinds); ++i)
+    {
+        if (rc->bind_count == RC_MAX_BINDS) break;
+        rc->binds[rc->bind_count] = my_keybinds[i];
+        rc->cmds[rc->bind_count][0] = '\0';
+        rc->bind_count++;
+    }
+}
+
+static void rcfile_locate(rcfile_t *rc)
+{
+    const char *xdg = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+
+    rc->dir[0] = '\0';
+    rc->path[0] = '\0';
+
+    if (xdg && xdg[0])
+        snprintf(rc->dir, sizeof(rc->dir), "%s/qwm", xdg);
+    else if (home && home[0])
+        snprintf(rc->dir, sizeof(rc->dir), "%s/.config/qwm", home);
+    else
+        return;
+
+    snprintf(rc->path, sizeof(rc->path), "%s/%s", rc->dir, RC_FILE_NAME);
+}
+
+/*****************************
+ * RCFILE
+ *****************************/
+
+void rcfile_init(struct qwm_t *qwm, rcfile_t *rc)
+{
+    (void)qwm;
+    rc->inotify_fd = -1;
+    rcfile_locate(rc);
+    rcfile_load(rc);
+
+    if (!rc->dir[0]) return;
+
+    // watch the directory, editors usually replace the file on save
+    rc->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (rc->inotify_fd < 0) return;
+
+    if (inotify_add_watch(rc->inotify_fd, rc->dir,
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE) < 0)
+    {
+        close(rc->inotify_fd);
+        rc->inotify_fd = -1;
+    }
+}
+
+void rcfile_kill(rcfile_t *rc)
+{
+    if (rc->inotify_fd >= 0) close(rc->inotify_fd);
+    rc->inotify_fd = -1;
+}
+
+int32_t rcfile_load(rcfile_t *rc)
+{
+    rcfile_defaults(rc);
+    if (!rc->path[0]) return -1;
+
+    int fd = open(rc->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char *buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED) return -1;
+
+    const char *p = buf;
+    const char *end = buf + size;
+    while (p < end)
+    {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+
+        parse_line(rc, p, eol);
+        p = eol + 1;
+    }
+
+    munmap((void *)buf, size);
+    return 0;
+}
+
+void rcfile_apply(struct qwm_t *qwm, rcfile_t *rc)
+{
+    static const uint16_t lock_masks[] = {0, XCB_MOD_MASK_LOCK, XCB_MOD_MASK_2,
+                                          XCB_MOD_MASK_LOCK | XCB_MOD_MASK_2};
+
+    qwm->keybinds = rc->binds;
+    qwm->keybind_count = rc->bind_count;
+
+    xcb_ungrab_key(qwm->conn, XCB_GRAB_ANY, qwm->root, XCB_MOD_MASK_ANY);
+    for (uint32_t i = 0; i < rc->bind_count; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            xcb_grab_key(qwm->conn, 1, qwm->root,
+                         rc->binds[i].mod | lock_masks[j], rc->binds[i].key,
+                         XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC);
+        }
+    }
+
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+    {
+        taskbar_t *tb = &qwm->monitors[m].taskbar;
+        if (!tb->win) continue;
+
+        taskbar_set_colors(qwm, tb);
+    }
+
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+    {
+        workspace_t *w = &qwm->workspaces[ws];
+        for (client_t *c = w->clients; c; c = c->next)
+        {
+            uint32_t pixel =
+                (c == w->focused) ? rc->border_focus : rc->border_unfocus;
+            xcb_change_window_attributes(qwm->conn, c->win,
+                                         XCB_CW_BORDER_PIXEL, &pixel);
+        }
+    }
+}
+
+int32_t rcfile_handle_event(struct qwm_t *qwm, rcfile_t *rc)
+{
+    char buf[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    int32_t reload = 0;
+
+    for (;;)
+    {
+        ssize_t len = read(rc->inotify_fd, buf, sizeof(buf));
+        if (len <= 0) break;
+
+        for (char *p = buf; p < buf + len;)
+        {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            if (ev->len && strcmp(ev->name, RC_FILE_NAME) == 0) reload = 1;
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+
+    if (!reload) return 0;
+
+    rcfile_load(rc);
+    rcfile_apply(qwm, rc);
+    xcb_flush(qwm->conn);
+    return 1;
+}
+
+void rcfile_run_bind(struct qwm_t *qwm, rcfile_t *rc, uint32_t i)
+{
+    if (i >= rc->bind_count) return;
+
+    if (rc->binds[i].func)
+        rc->binds[i].func(qwm);
+    else if (rc->cmds[i][0])
+        spawn("/bin/sh", "-c", rc->cmds[i], NULL);
+}
@@ -0,0 +1,63 @@
+/*
+ * Runtime config file
+ * Optional overrides on top of config.h, reloaded on change.
+ *
+ * Lookup: $XDG_CONFIG_HOME/qwm/qwmrc, then ~/.config/qwm/qwmrc
+ *
+ *   # comment
+ *   border_focus        0x6699CC
+ *   border_unfocus      #222222
+ *   taskbar_color       0x444444
+ *   taskbar_font_color  0xDDDDDD
+ *   launcher_bg_color   0x444444
+ *   launcher_fg_color   0x666666
+ *   launcher_font_color 0xDDDDDD
+ *
+ *   bind   super+shift 1 move_to_workspace_1
+ *   bind   super enter   spawn kitty --single-instance
+ *   unbind super b
+ */
+
+#ifndef RCFILE_H
+#define RCFILE_H
+
+#include "config_api.h"
+
+struct qwm_t;
+
+#define RC_MAX_BINDS 64
+#define RC_CMD_LEN 128
+#define RC_FILE_NAME "qwmrc"
+
+typedef struct {
+    uint32_t border_focus;
+    uint32_t border_unfocus;
+    uint32_t taskbar_color;
+    uint32_t taskbar_font_color;
+    uint32_t launcher_bg_color;
+    uint32_t launcher_fg_color;
+    uint32_t launcher_font_color;
+
+    // binds with a NULL func spawn cmds[i] through the shell
+    keybind_t binds[RC_MAX_BINDS];
+    char cmds[RC_MAX_BINDS][RC_CMD_LEN];
+    uint32_t bind_count;
+
+    char dir[256];
+    char path[512];
+    int inotify_fd;
+} rcfile_t;
+
+void rcfile_init(struct qwm_t *qwm, rcfile_t *rc);
+
+void rcfile_kill(rcfile_t *rc);
+
+int32_t rcfile_load(rcfile_t *rc);
+
+void rcfile_apply(struct qwm_t *qwm, rcfile_t *rc);
+
+int32_t rcfile_handle_event(struct qwm_t *qwm, rcfile_t *rc);
+
+void rcfile_run_bind(struct qwm_t *qwm, rcfile_t *rc, uint32_t i);
+
+#endif // RCFILE_H
@@ -0,0 +1,142 @@
+#include "qwm.h"
+#include "rules.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RULE_COUNT (sizeof(my_rules) / sizeof(my_rules[0]))
+
+// FNV-1a over len bytes
+static uint32_t hash_str(const char *s, uint32_t len)
+{
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int32_t str_eq(const char *rule, const char *s, uint32_t len)
+{
+    return strlen(rule) == len && memcmp(rule, s, len) == 0;
+}
+
+static int32_t title_has(const char *needle, const char *title, uint32_t len)
+{
+    uint32_t n = (uint32_t)strlen(needle);
+    if (n > len) return 0;
+
+    for (uint32_t i = 0; i + n <= len; ++i)
+    {
+        if (memcmp(title + i, needle, n) == 0) return 1;
+    }
+    return 0;
+}
+
+/*****************************
+ * RULES
+ *****************************/
+
+void rules_init(rules_t *r)
+{
+    memset(r, 0, sizeof(*r));
+
+    r->class_hash = calloc(RULE_COUNT, sizeof(*r->class_hash));
+    if (!r->class_hash) return;
+
+    for (uint32_t i = 0; i < RULE_COUNT; ++i)
+    {
+        const rule_t *rule = &my_rules[i];
+        if (rule->class)
+        {
+            r->class_hash[i] =
+                hash_str(rule->class, (uint32_t)strlen(rule->class));
+        }
+        if (rule->title) r->need_title = 1;
+    }
+    r->count = RULE_COUNT;
+}
+
+void rules_kill(rules_t *r)
+{
+    free(r->class_hash);
+    r->class_hash = NULL;
+    r->count = 0;
+}
+
+void rules_apply(struct qwm_t *wm, xcb_window_t win, rule_result_t *res)
+{
+    rules_t *r = &wm->rules;
+
+    res->workspace = wm->current_ws;
+    res->floating = 0;
+    res->focus = 1;
+    if (!r->count) return;
+
+    // both requests go out before waiting on either reply
+    xcb_get_property_cookie_t class_ck =
+        xcb_get_property(wm->conn, 0, win, XCB_ATOM_WM_CLASS,
+                         XCB_ATOM_STRING, 0, 64);
+    xcb_get_property_cookie_t title_ck;
+    if (r->need_title)
+    {
+        title_ck = xcb_get_property(wm->conn, 0, win, wm->atom.net_wm_name,
+                                    XCB_GET_PROPERTY_TYPE_ANY, 0, 64);
+    }
+
+    // WM_CLASS is "instance\0class\0"
+    xcb_get_property_reply_t *cls =
+        xcb_get_property_reply(wm->conn, class_ck, NULL);
+    const char *instance = "", *class = "";
+    uint32_t inst_len = 0, class_len = 0;
+
+    if (cls && cls->format == 8)
+    {
+        const char *v = xcb_get_property_value(cls);
+        uint32_t len = (uint32_t)xcb_get_property_value_length(cls);
+
+        instance = v;
+        inst_len = (uint32_t)strnlen(v, len);
+        if (inst_len + 1 < len)
+        {
+            class = v + inst_len + 1;
+            class_len = (uint32_t)strnlen(class, len - inst_len - 1);
+        }
+    }
+
+    xcb_get_property_reply_t *ttl =
+        r->need_title ? xcb_get_property_reply(wm->conn, title_ck, NULL)
+                      : NULL;
+    const char *title = ttl ? xcb_get_property_value(ttl) : "";
+    uint32_t title_len =
+        ttl ? (uint32_t)xcb_get_property_value_length(ttl) : 0;
+
+    uint32_t h = hash_str(class, class_len);
+
+    for (uint32_t i = 0; i < r->count; ++i)
+    {
+        const rule_t *rule = &my_rules[i];
+
+        if (rule->class && (r->class_hash[i] != h ||
+                            !str_eq(rule->class, class, class_len)))
+            continue;
+        if (rule->instance && !str_eq(rule->instance, instance, inst_len))
+            continue;
+        if (rule->title && !title_has(rule->title, title, title_len))
+            continue;
+
+        if (rule->workspace >= 1 && rule->workspace <= WORKSPACE_COUNT)
+        {
+            res->workspace = (uint16_t)(wm->current_mon * WORKSPACE_COUNT +
+                                        rule->workspace - 1);
+        }
+        res->floating = rule->floating;
+        res->focus = rule->focus;
+        break;
+    }
+
+    free(cls);
+    free(ttl);
+}
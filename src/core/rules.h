@@ -0,0 +1,34 @@
+/*
+ * Window rules
+ * my_rules in config.h, matched once per MapRequest before the window is
+ * first mapped. Class strings are hashed at startup so a lookup only
+ * compares strings for rules whose class hash matches.
+ */
+
+#ifndef RULES_H
+#define RULES_H
+
+#include <xcb/xcb.h>
+
+struct qwm_t;
+
+typedef struct {
+    uint32_t *class_hash; // per rule, 0 for rules without a class
+    uint32_t count;
+    uint8_t need_title;
+} rules_t;
+
+typedef struct {
+    uint16_t workspace;
+    uint8_t floating;
+    uint8_t focus;
+} rule_result_t;
+
+void rules_init(rules_t *r);
+
+void rules_kill(rules_t *r);
+
+// fills res with the defaults when no rule matches
+void rules_apply(struct qwm_t *wm, xcb_window_t win, rule_result_t *res);
+
+#endif // RULES_H
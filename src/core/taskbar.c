@@ -5,56 +5,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define LEFT_PAD 8
 #define RIGHT_PAD 8
+#define SEG_SPACING 8
 
-static void taskbar_draw_text(struct qwm_t *qwm, taskbar_t *tb, uint16_t x,
-                              const char *text)
-{
-    xcb_image_text_8(qwm->conn, (uint8_t)strlen(text), tb->win, tb->gc,
-                     (int16_t)x, 16, text);
-}
-
-/*
-static uint16_t text_px_width(xcb_connection_t *conn, xcb_font_t font,
-                              const char *text)
-{
-    // Core X fonts are always 2-byte per character, even for ASCII.
-    // The high byte MUST be initialized (usually zero), otherwise xcb
-    // will send uninitialized data to the X server.
-    uint64_t len = strlen(text);
-    xcb_char2b_t *chars = calloc(len, sizeof(xcb_char2b_t));
-    if (!chars) return 0;
-
-    for (uint64_t i = 0; i < len; ++i)
-    {
-        chars[i].byte1 = 0;
-        chars[i].byte2 = (uint8_t)text[i];
-    }
-
-    xcb_query_text_extents_cookie_t cookie =
-        xcb_query_text_extents(conn, font, (uint32_t)len, chars);
-    xcb_query_text_extents_reply_t *rep =
-        xcb_query_text_extents_reply(conn, cookie, NULL);
-
-    free(chars);
-    if (!rep) return 0;
-
-    uint16_t width = (uint16_t)rep->overall_width;
-    free(rep);
-    return width;
-}
-*/
-
-static void taskbar_draw_right_text(struct qwm_t *qwm, taskbar_t *tb,
-                                    const char *text, uint16_t spacing)
-{
-    uint16_t text_width = (uint16_t)strlen(text) * tb->char_width;
-    tb->right_x -= text_width;
+#define SLOT_PAD 4
+#define SLOT_MIN_W 48
 
-    taskbar_draw_text(qwm, tb, tb->right_x, text);
+#define GRAPH_MARGIN 5 // px above and below graph columns
 
-    tb->right_x -= spacing;
-}
+#define ITEMS_SIZE 4096 // PolyText8 items of one repaint
 
 static xcb_atom_t get_atom(xcb_connection_t *conn, const char *name)
 {
@@ -92,16 +52,14 @@ static const char *layout_name(layout_type_t t)
     }
 }
 
-static void format_uptime(uint64_t min, char *buf, size_t sz)
+static int format_uptime(uint64_t min, char *buf, size_t sz)
 {
     int d = (int)min / (60 * 24);
     int h = (min / 60) % 24;
     int m = min % 60;
 
-    if (d > 0)
-        snprintf(buf, sz, "| %dd %02dh %02dm", d, h, m);
-    else
-        snprintf(buf, sz, "| %02dh %02dm", h, m);
+    if (d > 0) return snprintf(buf, sz, "| %dd %02dh %02dm", d, h, m);
+    return snprintf(buf, sz, "| %02dh %02dm", h, m);
 }
 
 static const char *connection_type_str(connect_type_t type)
@@ -125,24 +83,513 @@ static const char *connection_state_str(connect_state_t state)
     }
 }
 
+static void create_pixmap(struct qwm_t *qwm, taskbar_t *tb)
+{
+    tb->pixmap = xcb_generate_id(qwm->conn);
+    xcb_create_pixmap(qwm->conn, qwm->screen->root_depth, tb->pixmap, tb->win,
+                      tb->width, tb->height);
+    tb->drawn = 0;
+}
+
+// the rasterizer always presents whole columns, the bar is one line
+static void present(struct qwm_t *qwm, taskbar_t *tb, int16_t x, int16_t y,
+                    uint16_t w, uint16_t h)
+{
+    if (tb->raster.pixels)
+        raster_put(qwm, &tb->raster, tb->win, tb->gc, x, w);
+    else
+        xcb_copy_area(qwm->conn, tb->pixmap, tb->win, tb->gc, x, y, x, y, w,
+                      h);
+}
+
+static void fill(struct qwm_t *qwm, taskbar_t *tb, xcb_gcontext_t gc,
+                 uint32_t color, const xcb_rectangle_t *r, uint32_t n)
+{
+    if (!tb->raster.pixels)
+    {
+        xcb_poly_fill_rectangle(qwm->conn, tb->pixmap, gc, n, r);
+        return;
+    }
+
+    for (uint32_t i = 0; i < n; ++i)
+        raster_fill(&tb->raster, r[i].x, r[i].y, r[i].width, r[i].height,
+                    color);
+}
+
+/*****************************
+ * SEGMENTS
+ *****************************/
+
+// FNV-1a, keys string inputs without formatting them
+static uint64_t key_str(const char *s)
+{
+    uint64_t h = 14695981039346656037ull;
+    while (*s)
+    {
+        h ^= (uint8_t)*s++;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// 1 when the segment must be formatted from its inputs again
+static int32_t seg_stale(taskbar_seg_t *s, uint64_t key)
+{
+    if (s->valid && s->key == key) return 0;
+    s->valid = 1;
+    s->key = key;
+    return 1;
+}
+
+static void seg_text(taskbar_t *tb, taskbar_seg_t *s, int n)
+{
+    if (n < 0) n = 0;
+    if (n >= (int)sizeof(s->text)) n = sizeof(s->text) - 1;
+
+    s->len = (uint8_t)n;
+    s->w = (uint16_t)font_text_width(tb->font, s->text, s->len);
+    s->dirty = 1;
+}
+
+// graphs show up with their first sample, a shown one is keyed on gen
+static void seg_graph(taskbar_seg_t *s, const spark_t *sp, int32_t shown)
+{
+    const spark_t *want = shown && sp->count ? sp : NULL;
+    if (s->spark != want) s->dirty = 1;
+
+    s->spark = want;
+    s->len = 0;
+    s->w = want ? SPARK_LEN : 0;
+}
+
+static void segs_format(struct qwm_t *qwm, taskbar_t *tb, tray_status_t *ts)
+{
+    taskbar_seg_t *s;
+    uint16_t cur = qwm->monitors[tb->mon].cur_ws;
+
+    s = &tb->segs[SEG_TITLE];
+    if (seg_stale(s, 0))
+        seg_text(tb, s, snprintf(s->text, sizeof(s->text), "qwm"));
+
+    uint16_t count = 0;
+    for (client_t *c = qwm->workspaces[cur].clients; c; c = c->next) count++;
+
+    s = &tb->segs[SEG_WORKSPACE];
+    if (seg_stale(s, (uint64_t)WS_NUMBER(cur) << 16 | count))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "| WS%d (%d)",
+                          WS_NUMBER(cur) + 1, count));
+    }
+
+    layout_type_t type = qwm->workspaces[cur].type;
+    s = &tb->segs[SEG_LAYOUT];
+    if (seg_stale(s, type))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "%s", layout_name(type)));
+    }
+
+    s = &tb->segs[SEG_DATE];
+    if (seg_stale(s, key_str(ts->time_date.date)))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "%s",
+                          ts->time_date.date));
+    }
+
+    s = &tb->segs[SEG_TIME];
+    if (seg_stale(s, key_str(ts->time_date.time)))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "%s",
+                          ts->time_date.time));
+    }
+
+    s = &tb->segs[SEG_GOV];
+    if (seg_stale(s, key_str(ts->gov.name)))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "| %s", ts->gov.name));
+    }
+
+    seg_graph(&tb->segs[SEG_FREQ_GRAPH], &ts->cpu.hist, 1);
+    seg_graph(&tb->segs[SEG_MEM_GRAPH], &ts->mems.hist, 1);
+    seg_graph(&tb->segs[SEG_BAT_GRAPH], &ts->bat.hist, ts->bat.capacity > 0);
+
+    s = &tb->segs[SEG_FREQ];
+    if (seg_stale(s, (uint64_t)(uint32_t)ts->cpu.mhz))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "| %d.%02dGHz",
+                          ts->cpu.mhz / 1000, (ts->cpu.mhz % 1000) / 10));
+    }
+
+    s = &tb->segs[SEG_MEM];
+    if (seg_stale(s, (uint64_t)ts->mems.current << 32 | ts->mems.total))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "| %d/%dMB",
+                          ts->mems.current, ts->mems.total));
+    }
+
+    const battery_t *bat = &ts->bat;
+    s = &tb->segs[SEG_BATTERY];
+    if (seg_stale(s, (uint64_t)bat->tte_min << 32 |
+                         (uint64_t)bat->capacity << 8 | bat->state))
+    {
+        int n = 0;
+        if (bat->capacity > 0 && bat->tte_min)
+        {
+            n = snprintf(s->text, sizeof(s->text), "| %d%% (%s %dh%02dm)",
+                         bat->capacity, battery_status_string(bat->state),
+                         bat->tte_min / 60, bat->tte_min % 60);
+        }
+        else if (bat->capacity > 0)
+        {
+            n = snprintf(s->text, sizeof(s->text), "| %d%% (%s)",
+                         bat->capacity, battery_status_string(bat->state));
+        }
+        seg_text(tb, s, n);
+    }
+
+    s = &tb->segs[SEG_UPTIME];
+    if (seg_stale(s, ts->up.current))
+    {
+        seg_text(tb, s,
+                 format_uptime(ts->up.current, s->text, sizeof(s->text)));
+    }
+
+    s = &tb->segs[SEG_NET];
+    if (seg_stale(s, key_str(ts->connection.name) ^ ts->connection.cn_type))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "%s: %s",
+                          connection_type_str(ts->connection.cn_type),
+                          ts->connection.name));
+    }
+
+    s = &tb->segs[SEG_NET_STATE];
+    if (seg_stale(s, ts->connection.cn_state))
+    {
+        seg_text(tb, s,
+                 snprintf(s->text, sizeof(s->text), "%s",
+                          connection_state_str(ts->connection.cn_state)));
+    }
+}
+
+// positions, a segment that moves is repainted as well
+static void segs_layout(taskbar_t *tb)
+{
+    int32_t x = LEFT_PAD;
+    for (uint32_t i = 0; i < SEG_SLOT; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[i];
+        if (!s->w) continue;
+
+        if (s->x != x) s->dirty = 1;
+        s->x = (int16_t)x;
+        x += s->w + SEG_SPACING;
+    }
+
+    x = tb->width - RIGHT_PAD;
+    for (uint32_t i = SEG_FIRST_RIGHT; i < SEG_COUNT; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[i];
+        if (!s->w) continue;
+
+        x -= s->w;
+        if (s->x != x) s->dirty = 1;
+        s->x = (int16_t)x;
+        x -= SEG_SPACING;
+    }
+}
+
+static uint64_t key_mix(uint64_t h, uint64_t v)
+{
+    return (h ^ v) * 1099511628211ull;
+}
+
+// cuts the title to fit max px, ending in ".." when it had to be cut
+static uint8_t fit_title(const font_t *f, char *dst, const client_t *c,
+                         uint32_t max)
+{
+    if (font_text_width(f, c->title, c->title_len) <= max)
+    {
+        memcpy(dst, c->title, c->title_len);
+        return c->title_len;
+    }
+
+    uint32_t dots = font_text_width(f, "..", 2);
+    uint32_t w = 0;
+    uint8_t n = 0;
+    while (n < c->title_len &&
+           w + f->width[(uint8_t)c->title[n]] + dots <= max)
+        w += f->width[(uint8_t)c->title[n++]];
+
+    memcpy(dst, c->title, n);
+    if (w + dots <= max)
+    {
+        dst[n++] = '.';
+        dst[n++] = '.';
+    }
+    return n;
+}
+
+// one equal slot per window in the space the other segments leave
+static void slots_update(struct qwm_t *qwm, taskbar_t *tb)
+{
+    workspace_t *w = &qwm->workspaces[qwm->monitors[tb->mon].cur_ws];
+
+    int32_t lo = LEFT_PAD, hi = tb->width - RIGHT_PAD;
+    for (uint32_t i = 0; i < SEG_SLOT; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[i];
+        if (s->w && s->x + s->w + SEG_SPACING > lo)
+            lo = s->x + s->w + SEG_SPACING;
+    }
+    for (uint32_t i = SEG_FIRST_RIGHT; i < SEG_COUNT; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[i];
+        if (s->w && s->x - SEG_SPACING < hi) hi = s->x - SEG_SPACING;
+    }
+
+    uint32_t n = 0;
+    for (client_t *c = w->clients; c && n < TASKBAR_SLOTS; c = c->next) n++;
+    if (hi - lo < (int32_t)(n * SLOT_MIN_W))
+        n = hi > lo ? (uint32_t)(hi - lo) / SLOT_MIN_W : 0;
+
+    uint16_t slot_w = n ? (uint16_t)((hi - lo) / (int32_t)n) : 0;
+    client_t *c = w->clients;
+
+    for (uint32_t i = 0; i < TASKBAR_SLOTS; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[SEG_SLOT + i];
+
+        if (i >= n)
+        {
+            if (s->valid) s->dirty = 1;
+            s->valid = 0;
+            s->len = 0;
+            s->w = 0;
+            s->hl = 0;
+            continue;
+        }
+
+        int16_t x = (int16_t)(lo + (int32_t)i * slot_w);
+        if (s->x != x || s->w != slot_w) s->dirty = 1;
+        s->x = x;
+        s->w = slot_w;
+        s->pad = SLOT_PAD;
+
+        uint8_t hl = (c == w->focused);
+        uint64_t key = key_mix(key_mix(key_mix(c->win, c->title_gen),
+                                       slot_w),
+                               hl);
+        if (seg_stale(s, key))
+        {
+            s->hl = hl;
+            s->len = fit_title(tb->font, s->text, c, slot_w - 2 * SLOT_PAD);
+            s->dirty = 1;
+        }
+        c = c->next;
+    }
+}
+
+// text element, zero length elements carry deltas past int8 range
+static uint32_t put_item(uint8_t *items, uint32_t n, int32_t delta,
+                         const char *text, uint8_t len)
+{
+    for (; delta > 127 && n + 2 <= ITEMS_SIZE; delta -= 127)
+    {
+        items[n++] = 0;
+        items[n++] = 127;
+    }
+    for (; delta < -128 && n + 2 <= ITEMS_SIZE; delta += 128)
+    {
+        items[n++] = 0;
+        items[n++] = (uint8_t)-128;
+    }
+    if (n + 2u + len > ITEMS_SIZE) return n;
+
+    items[n++] = len;
+    items[n++] = (uint8_t)(int8_t)delta;
+    memcpy(items + n, text, len);
+    return n + len;
+}
+
+// columns of the newest n samples, the newest at the right edge
+static void graph_paint(struct qwm_t *qwm, taskbar_t *tb,
+                        const taskbar_seg_t *s, uint32_t n)
+{
+    const spark_t *sp = s->spark;
+    int32_t h = tb->height - 2 * GRAPH_MARGIN;
+    xcb_rectangle_t cols[SPARK_LEN];
+
+    if (n > sp->count) n = sp->count;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint8_t v = sp->v[(sp->head + SPARK_LEN - 1 - i) % SPARK_LEN];
+        int32_t ch = 1 + v * (h - 1) / 255;
+        cols[i] = (xcb_rectangle_t){(int16_t)(s->x + s->w - 1 - (int32_t)i),
+                                    (int16_t)(GRAPH_MARGIN + h - ch), 1,
+                                    (uint16_t)ch};
+    }
+    if (n) fill(qwm, tb, tb->gc, qwm->rc.taskbar_font_color, cols, n);
+}
+
+// graphs that only gained samples scroll in place, returns 1 if any did
+static int32_t graphs_shift(struct qwm_t *qwm, taskbar_t *tb, int32_t *lo,
+                            int32_t *hi)
+{
+    int32_t shifted = 0;
+
+    for (uint32_t i = SEG_FIRST_RIGHT; i < SEG_COUNT; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[i];
+        if (!s->spark || s->dirty || s->key == s->spark->gen) continue;
+
+        uint32_t d = s->spark->gen - (uint32_t)s->key;
+        s->key = s->spark->gen;
+
+        // the raster redraws the whole graph, it is all in local memory
+        if (d > SPARK_LEN || tb->raster.pixels) d = SPARK_LEN;
+        if (d < SPARK_LEN)
+        {
+            xcb_copy_area(qwm->conn, tb->pixmap, tb->pixmap, tb->gc,
+                          (int16_t)(s->x + d), 0, s->x, 0,
+                          (uint16_t)(s->w - d), tb->height);
+        }
+
+        xcb_rectangle_t r = {(int16_t)(s->x + s->w - d), 0, (uint16_t)d,
+                             tb->height};
+        fill(qwm, tb, tb->bg_gc, qwm->rc.taskbar_color, &r, 1);
+        graph_paint(qwm, tb, s, d);
+
+        if (s->x < *lo) *lo = s->x;
+        if (s->x + s->w > *hi) *hi = s->x + s->w;
+        shifted = 1;
+    }
+    return shifted;
+}
+
+// full: the whole pixmap was refilled and goes out in one copy
+static void segs_paint(struct qwm_t *qwm, taskbar_t *tb, int32_t full)
+{
+    xcb_rectangle_t bg_fill[SEG_COUNT * 2];
+    xcb_rectangle_t hl_fill[TASKBAR_SLOTS];
+    uint32_t nfill = 0, nhl = 0;
+    int32_t lo = tb->width, hi = 0;
+    int32_t shifted = graphs_shift(qwm, tb, &lo, &hi);
+
+    for (uint32_t i = 0; i < SEG_COUNT; ++i)
+    {
+        taskbar_seg_t *s = &tb->segs[i];
+        if (!s->dirty) continue;
+
+        // old extent and new extent, both back to the bar color
+        if (s->drawn_w)
+        {
+            bg_fill[nfill++] = (xcb_rectangle_t){s->drawn_x, 0, s->drawn_w,
+                                                 tb->height};
+            if (s->drawn_x < lo) lo = s->drawn_x;
+            if (s->drawn_x + s->drawn_w > hi) hi = s->drawn_x + s->drawn_w;
+        }
+        if (s->len || s->hl || s->spark)
+        {
+            xcb_rectangle_t r = {s->x, 0, s->w, tb->height};
+            if (s->hl)
+                hl_fill[nhl++] = r;
+            else
+                bg_fill[nfill++] = r;
+            if (s->x < lo) lo = s->x;
+            if (s->x + s->w > hi) hi = s->x + s->w;
+        }
+    }
+    if (!nfill && !nhl && !shifted && !full) return;
+
+    const rcfile_t *rc = &qwm->rc;
+    if (!full && nfill)
+        fill(qwm, tb, tb->bg_gc, rc->taskbar_color, bg_fill, nfill);
+    if (nhl) fill(qwm, tb, tb->hl_gc, rc->border_focus, hl_fill, nhl);
+
+    uint8_t items[ITEMS_SIZE];
+    uint32_t n = 0;
+    int32_t start = -1, pen = 0;
+
+    // left side and slots ascend, the right side descends, so the pen
+    // only ever moves forward
+    for (uint32_t k = 0; k < SEG_COUNT; ++k)
+    {
+        uint32_t i =
+            k < SEG_FIRST_RIGHT ? k : SEG_COUNT - 1 - (k - SEG_FIRST_RIGHT);
+        taskbar_seg_t *s = &tb->segs[i];
+        if (!s->dirty) continue;
+
+        s->dirty = 0;
+        s->drawn_x = s->x;
+        s->drawn_w = (s->len || s->hl || s->spark) ? s->w : 0;
+        if (s->spark)
+        {
+            graph_paint(qwm, tb, s, SPARK_LEN);
+            s->key = s->spark->gen;
+            continue;
+        }
+        if (!s->len) continue;
+
+        int32_t x = s->x + s->pad;
+        if (tb->raster.pixels)
+        {
+            raster_text(&tb->raster, x, tb->text_y, s->text, s->len,
+                        rc->taskbar_font_color);
+            continue;
+        }
+
+        if (start < 0) start = pen = x;
+        n = put_item(items, n, x - pen, s->text, s->len);
+        pen = x + (int32_t)font_text_width(tb->font, s->text, s->len);
+    }
+
+    if (n)
+    {
+        xcb_poly_text_8(qwm->conn, tb->pixmap, tb->gc, (int16_t)start,
+                        tb->text_y, n, items);
+    }
+
+    if (full)
+    {
+        present(qwm, tb, 0, 0, tb->width, tb->height);
+        return;
+    }
+
+    if (lo < 0) lo = 0;
+    if (hi > tb->width) hi = tb->width;
+    if (hi > lo)
+        present(qwm, tb, (int16_t)lo, 0, (uint16_t)(hi - lo), tb->height);
+}
+
 /*****************************
  * TASKBAR
  *****************************/
 
-void taskbar_init(struct qwm_t *qwm, taskbar_t *tb)
+void taskbar_init(struct qwm_t *qwm, taskbar_t *tb, uint16_t mon)
 {
+    monitor_t *m = &qwm->monitors[mon];
+
+    tb->mon = mon;
     tb->height = 24;
-    tb->width = qwm->w;
-    tb->y_pos = qwm->screen->height_in_pixels - tb->height;
-    tb->right_x = tb->width - RIGHT_PAD;
+    tb->x = m->x;
+    tb->width = m->w;
+    tb->y_pos = (uint16_t)(m->y + m->h - tb->height);
 
     // clang-format off
-    uint32_t mask = XCB_CW_BACK_PIXEL | XCB_CW_OVERRIDE_REDIRECT | XCB_CW_EVENT_MASK;
-    uint32_t values[3] = {TASKBAR_COLOR, 1, XCB_EVENT_MASK_EXPOSURE};
+    // no background, exposed areas are covered by the pixmap copy
+    uint32_t mask = XCB_CW_BACK_PIXMAP | XCB_CW_OVERRIDE_REDIRECT | XCB_CW_EVENT_MASK;
+    uint32_t values[3] = {XCB_BACK_PIXMAP_NONE, 1, XCB_EVENT_MASK_EXPOSURE};
 
 	tb->win = xcb_generate_id(qwm->conn);
     xcb_create_window(qwm->conn, XCB_COPY_FROM_PARENT, tb->win, qwm->root,
-        0, (int16_t)tb->y_pos, // position x,y
+        tb->x, (int16_t)tb->y_pos, // position x,y
         tb->width, tb->height, // size
         0, // border
         XCB_WINDOW_CLASS_INPUT_OUTPUT, qwm->screen->root_visual, mask, values);
@@ -162,95 +609,154 @@ void taskbar_init(struct qwm_t *qwm, taskbar_t *tb)
 
     xcb_map_window(qwm->conn, tb->win);
 
-    // setup font
-    tb->font = xcb_generate_id(qwm->conn);
-    xcb_open_font(qwm->conn, tb->font, 7, "fixed");
+    // client side drawing when built with USE_SHM_BAR and the screen
+    // allows it, else core fonts into a pixmap
+    if (raster_init(qwm, &tb->raster, tb->width, tb->height))
+        tb->font = raster_font();
+    else
+        tb->font = &qwm->font;
+
+    // baseline centers the glyph box in the bar
+    tb->text_y =
+        (int16_t)((tb->height + tb->font->ascent - tb->font->descent) / 2);
 
     // setup graphics context
     tb->gc = xcb_generate_id(qwm->conn);
-    uint32_t gc_values[] = {TASKBAR_FONT_COLOR, TASKBAR_COLOR, tb->font};
+    uint32_t gc_values[] = {qwm->rc.taskbar_font_color, qwm->rc.taskbar_color,
+                            qwm->font.id};
     xcb_create_gc(qwm->conn, tb->gc, tb->win,
                   XCB_GC_FOREGROUND | XCB_GC_BACKGROUND | XCB_GC_FONT,
                   gc_values);
 
-    // caching char pixel
-    xcb_char2b_t c = {0, 'A'};
-    xcb_query_text_extents_cookie_t ck =
-        xcb_query_text_extents(qwm->conn, tb->font, 1, &c);
-    xcb_query_text_extents_reply_t *rep =
-        xcb_query_text_extents_reply(qwm->conn, ck, NULL);
+    tb->bg_gc = xcb_generate_id(qwm->conn);
+    xcb_create_gc(qwm->conn, tb->bg_gc, tb->win, XCB_GC_FOREGROUND,
+                  &qwm->rc.taskbar_color);
+
+    tb->hl_gc = xcb_generate_id(qwm->conn);
+    xcb_create_gc(qwm->conn, tb->hl_gc, tb->win, XCB_GC_FOREGROUND,
+                  &qwm->rc.border_focus);
 
-    tb->char_width = rep ? (uint16_t)rep->overall_width : 8;
-    free(rep);
+    if (!tb->raster.pixels) create_pixmap(qwm, tb);
 
     xcb_flush(qwm->conn);
 }
 
-void taskbar_kill(struct qwm_t *qwm, taskbar_t *tb)
+void taskbar_place(struct qwm_t *qwm, taskbar_t *tb)
 {
-    if (!tb) return;
-    if (tb->gc) xcb_free_gc(qwm->conn, tb->gc);
-    if (tb->font) xcb_close_font(qwm->conn, tb->font);
-    if (tb->win) xcb_destroy_window(qwm->conn, tb->win);
-}
+    monitor_t *m = &qwm->monitors[tb->mon];
+    uint16_t y_pos = (uint16_t)(m->y + m->h - tb->height);
 
-void taskbar_draw(struct qwm_t *qwm, taskbar_t *tb, tray_status_t *ts)
-{
-    xcb_clear_area(qwm->conn, 0, tb->win, 0, 0, tb->width, tb->height);
+    if (tb->x == m->x && tb->y_pos == y_pos && tb->width == m->w) return;
 
-    // left side
-    taskbar_draw_text(qwm, tb, 8, "qwm");
+    tb->x = m->x;
+    if (tb->width != m->w)
+    {
+        tb->width = m->w;
+        tb->drawn = 0;
+        if (!tb->raster.pixels)
+        {
+            xcb_free_pixmap(qwm->conn, tb->pixmap);
+            create_pixmap(qwm, tb);
+        }
+        else
+        {
+            raster_kill(qwm, &tb->raster);
+            if (!raster_init(qwm, &tb->raster, tb->width, tb->height))
+            {
+                // lost the buffer, core fonts from here on
+                tb->font = &qwm->font;
+                tb->text_y = (int16_t)((tb->height + tb->font->ascent -
+                                        tb->font->descent) / 2);
+                for (uint32_t i = 0; i < SEG_COUNT; ++i)
+                    tb->segs[i].valid = 0;
+                create_pixmap(qwm, tb);
+            }
+        }
+    }
+
+    tb->y_pos = y_pos;
+
+    uint32_t values[] = {(uint32_t)tb->x, tb->y_pos, tb->width};
+    xcb_configure_window(qwm->conn, tb->win,
+                         XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y |
+                             XCB_CONFIG_WINDOW_WIDTH,
+                         values);
+}
 
-    char ws[16];
-    snprintf(ws, sizeof(ws), "| WS%d (%d)", qwm->current_ws + 1,
-             ts->view.client_count);
-    taskbar_draw_text(qwm, tb, 32, ws);
+void taskbar_set_colors(struct qwm_t *qwm, taskbar_t *tb)
+{
+    uint32_t gc_values[] = {qwm->rc.taskbar_font_color, qwm->rc.taskbar_color};
+    xcb_change_gc(qwm->conn, tb->gc, XCB_GC_FOREGROUND | XCB_GC_BACKGROUND,
+                  gc_values);
+    xcb_change_gc(qwm->conn, tb->bg_gc, XCB_GC_FOREGROUND,
+                  &qwm->rc.taskbar_color);
+    xcb_change_gc(qwm->conn, tb->hl_gc, XCB_GC_FOREGROUND,
+                  &qwm->rc.border_focus);
+    tb->drawn = 0;
+}
 
-    const char *layout = layout_name(qwm->workspaces[qwm->current_ws].type);
-    taskbar_draw_text(qwm, tb, 96, layout);
+void taskbar_set_hidden(struct qwm_t *qwm, taskbar_t *tb, int32_t hidden)
+{
+    if (tb->hidden == !!hidden) return;
 
-    // right side
-    tb->right_x = tb->width - RIGHT_PAD;
-    uint16_t spacing = 8;
+    tb->hidden = !!hidden;
+    if (hidden)
+    {
+        xcb_unmap_window(qwm->conn, tb->win);
+        return;
+    }
 
-    taskbar_draw_right_text(qwm, tb, ts->time_date.date, spacing);
-    taskbar_draw_right_text(qwm, tb, ts->time_date.time, spacing);
+    // draws were skipped while hidden, the map's Expose repaints
+    tb->drawn = 0;
 
-    char gov_buf[16];
-    snprintf(gov_buf, sizeof(gov_buf), "| %s", ts->gov.name);
-    taskbar_draw_right_text(qwm, tb, gov_buf, spacing);
+    // back above whatever went fullscreen meanwhile
+    uint32_t v[] = {XCB_STACK_MODE_ABOVE};
+    xcb_configure_window(qwm->conn, tb->win, XCB_CONFIG_WINDOW_STACK_MODE, v);
+    xcb_map_window(qwm->conn, tb->win);
+}
 
-    char freq_buf[16];
-    snprintf(freq_buf, sizeof(freq_buf), "| %d.%02dGHz", ts->cpu.mhz / 1000,
-             (ts->cpu.mhz % 1000) / 10);
-    taskbar_draw_right_text(qwm, tb, freq_buf, spacing);
+void taskbar_kill(struct qwm_t *qwm, taskbar_t *tb)
+{
+    if (!tb) return;
+    if (tb->gc) xcb_free_gc(qwm->conn, tb->gc);
+    if (tb->bg_gc) xcb_free_gc(qwm->conn, tb->bg_gc);
+    if (tb->hl_gc) xcb_free_gc(qwm->conn, tb->hl_gc);
+    if (tb->pixmap) xcb_free_pixmap(qwm->conn, tb->pixmap);
+    raster_kill(qwm, &tb->raster);
+    if (tb->win) xcb_destroy_window(qwm->conn, tb->win);
+}
 
-    char mem[32];
-    snprintf(mem, sizeof(mem), "| %d/%dMB", ts->mems.current, ts->mems.total);
-    taskbar_draw_right_text(qwm, tb, mem, spacing);
+void taskbar_draw(struct qwm_t *qwm, taskbar_t *tb, tray_status_t *ts)
+{
+    if (tb->hidden) return;
 
-    if (ts->bat.capacity > 0)
+    // the server is still reading the buffer, redrawn on completion
+    if (tb->raster.busy)
     {
-        char bat[32];
-        const char *status_str = battery_status_string(ts->bat.state);
-        snprintf(bat, sizeof(bat), "| %d%% (%s)", ts->bat.capacity,
-                 status_str);
-        taskbar_draw_right_text(qwm, tb, bat, spacing);
+        tb->deferred = 1;
+        return;
     }
 
-    char up[16];
-    format_uptime(ts->up.current, up, sizeof(up));
-    taskbar_draw_right_text(qwm, tb, up, spacing);
+    segs_format(qwm, tb, ts);
 
-    char wifi[128];
-    snprintf(wifi, sizeof(wifi), "%s: %s",
-             connection_type_str(ts->connection.cn_type), ts->connection.name);
-    taskbar_draw_right_text(qwm, tb, wifi, spacing);
+    int32_t full = !tb->drawn;
+    if (full)
+    {
+        // stale back buffer, everything goes in again
+        xcb_rectangle_t bg = {0, 0, tb->width, tb->height};
+        fill(qwm, tb, tb->bg_gc, qwm->rc.taskbar_color, &bg, 1);
+
+        for (uint32_t i = 0; i < SEG_COUNT; ++i)
+        {
+            tb->segs[i].dirty = 1;
+            tb->segs[i].drawn_w = 0;
+        }
+        tb->drawn = 1;
+    }
 
-    char con_state[16];
-    snprintf(con_state, sizeof(con_state), "%s",
-             connection_state_str(ts->connection.cn_state));
-    taskbar_draw_right_text(qwm, tb, con_state, spacing);
+    segs_layout(tb);
+    slots_update(qwm, tb);
+    segs_paint(qwm, tb, full);
 
     xcb_flush(qwm->conn);
 }
@@ -258,5 +764,21 @@ void taskbar_draw(struct qwm_t *qwm, taskbar_t *tb, tray_status_t *ts)
 void taskbar_handle_expose(struct qwm_t *qwm, taskbar_t *tb,
                            xcb_expose_event_t *ev)
 {
-    if (ev->count == 0) taskbar_draw(qwm, tb, &qwm->tray);
+    if (!tb->drawn)
+    {
+        if (ev->count == 0) taskbar_draw(qwm, tb, &qwm->tray);
+        return;
+    }
+
+    // every exposed rect comes straight from the back buffer
+    present(qwm, tb, (int16_t)ev->x, (int16_t)ev->y, ev->width, ev->height);
+}
+
+void taskbar_shm_done(struct qwm_t *qwm, taskbar_t *tb)
+{
+    raster_done(&tb->raster);
+    if (!tb->deferred) return;
+
+    tb->deferred = 0;
+    taskbar_draw(qwm, tb, &qwm->tray);
 }
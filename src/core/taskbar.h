@@ -1,23 +1,105 @@
+/*
+ * Taskbar
+ * Drawn into a server side pixmap and presented with one copy, so the
+ * window never shows a half drawn bar. Expose only copies the pixmap back.
+ *
+ * The bar is a fixed list of segments. Each keeps its formatted text and
+ * a key of the inputs it was formatted from; a draw only formats segments
+ * whose key changed and only repaints those plus right side neighbours
+ * that had to shift. All repainted text goes out in one PolyText8.
+ *
+ * Title slots split the space between both sides. A slot is keyed on its
+ * client's title generation, width and focus, so a retitle repaints only
+ * that slot.
+ *
+ * Graph segments draw a metric's spark_t ring, one column per sample. The
+ * pixmap already holds the older columns, so a new sample copies the graph
+ * one column left and draws only the new one.
+ */
+
 #ifndef TASKBAR_H
 #define TASKBAR_H
 
 #include "views.h"
 #include "tray_status.h"
+#include "font.h"
+#include "raster.h"
 
 struct qwm_t;
 
+#define TASKBAR_SLOTS 16 // titles listed at most
+
+typedef enum {
+    // left, packed left to right
+    SEG_TITLE,
+    SEG_WORKSPACE,
+    SEG_LAYOUT,
+    // window titles of the shown workspace, between left and right
+    SEG_SLOT,
+    SEG_SLOT_LAST = SEG_SLOT + TASKBAR_SLOTS - 1,
+    // right, laid out right to left
+    SEG_DATE,
+    SEG_TIME,
+    SEG_GOV,
+    SEG_FREQ_GRAPH, // each graph sits right of its value
+    SEG_FREQ,
+    SEG_MEM_GRAPH,
+    SEG_MEM,
+    SEG_BAT_GRAPH,
+    SEG_BATTERY,
+    SEG_UPTIME,
+    SEG_NET,
+    SEG_NET_STATE,
+    SEG_COUNT,
+} taskbar_seg_id_t;
+
+#define SEG_FIRST_RIGHT SEG_DATE
+
+typedef struct {
+    char text[64];
+    uint8_t len; // 0 hides the segment
+    uint8_t valid;
+    uint8_t dirty;
+    uint8_t hl; // focused title slot, drawn on the highlight color
+    uint64_t key; // inputs text was formatted from, drawn gen of a graph
+    const spark_t *spark; // set on a shown graph segment, it has no text
+
+    int16_t x; // extent, text starts at x + pad
+    uint16_t w;
+    uint16_t pad;
+    int16_t drawn_x; // extent currently in the pixmap
+    uint16_t drawn_w;
+} taskbar_seg_t;
+
 typedef struct {
     xcb_window_t win;
-    uint16_t width, height, y_pos, right_x;
-    xcb_font_t font;
+    uint16_t mon;
+    int16_t x;
+    uint16_t width, height, y_pos;
+    const font_t *font; // qwm_t.font
+    int16_t text_y;     // baseline
     xcb_gcontext_t gc;
-    uint16_t char_width;
+    xcb_gcontext_t bg_gc; // fills the pixmap with the bar color
+    xcb_gcontext_t hl_gc; // focused title background
+    xcb_pixmap_t pixmap;  // back buffer, width x height
+    uint8_t drawn;        // pixmap holds a complete bar
+    taskbar_seg_t segs[SEG_COUNT];
+    raster_t raster; // used instead of pixmap when pixels is set
+    uint8_t deferred; // draw skipped while the raster was busy
+    uint8_t hidden; // unmapped under a fullscreen client
 } taskbar_t;
 
-void taskbar_init(struct qwm_t *qwm, taskbar_t *tb);
+void taskbar_init(struct qwm_t *qwm, taskbar_t *tb, uint16_t mon);
+
+void taskbar_place(struct qwm_t *qwm, taskbar_t *tb);
 
 void taskbar_kill(struct qwm_t *qwm, taskbar_t *tb);
 
+// after the rcfile changed colors
+void taskbar_set_colors(struct qwm_t *qwm, taskbar_t *tb);
+
+void taskbar_set_hidden(struct qwm_t *qwm, taskbar_t *tb, int32_t hidden);
+
 int32_t taskbar_update(struct qwm_t *qwm, taskbar_t *tb);
 
 void taskbar_draw(struct qwm_t *qwm, taskbar_t *tb, tray_status_t *ts);
@@ -25,4 +107,7 @@ void taskbar_draw(struct qwm_t *qwm, taskbar_t *tb, tray_status_t *ts);
 void taskbar_handle_expose(struct qwm_t *qwm, taskbar_t *tb,
                            xcb_expose_event_t *ev);
 
+// ShmCompletion for the bar's window
+void taskbar_shm_done(struct qwm_t *qwm, taskbar_t *tb);
+
 #endif // TASKBAR_H
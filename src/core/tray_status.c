@@ -2,152 +2,38 @@
 #include "tray_status.h"
 #include "util.h"
 
-#include <unistd.h>
-#include <sys/wait.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define BAT_CAPACITY "/sys/class/power_supply/BAT0/capacity"
-#define BAT_STATUS "/sys/class/power_supply/BAT0/status"
+#include <dirent.h>      // opendir, readdir
+#include <poll.h>        // poll, POLLIN
+#include <unistd.h>      // read, write, close
+#include <sys/eventfd.h> // eventfd, EFD_CLOEXEC, EFD_NONBLOCK
+#include <sys/socket.h>  // socket, bind, recv
+#include <linux/netlink.h> // NETLINK_KOBJECT_UEVENT
+
+#define POWER_SUPPLY_DIR "/sys/class/power_supply"
+#define POWER_POLL_SEC 60   // level and rate, status changes come as uevents
+#define POWER_GRAPH_EVERY 5 // timed reads per graph sample
 #define CPU_GOV_PATH "/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor"
 #define CPU_FREQ_PATH "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq"
+#define CPU_MAX_PATH "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq"
 #define MEMINFO_PATH "/proc/meminfo"
 
-static int32_t get_active_connection(char *name, size_t namesz, char *type,
-                                     size_t typesz)
-{
-    int pipefd[2];
-    if (pipe(pipefd) < 0) return -1;
-
-    pid_t pid = fork();
-    if (pid < 0) return -1;
-    if (pid == 0)
-    {
-        close(pipefd[0]);
-        dup2(pipefd[1], STDOUT_FILENO);
-        close(pipefd[1]);
-
-        execlp("nmcli", "nmcli", "-t", "-f", "NAME,TYPE", "connection", "show",
-               "--active", (char *)NULL);
-        _exit(1);
-    }
-    close(pipefd[1]);
-
-    FILE *fp = fdopen(pipefd[0], "r");
-    if (!fp) return -1;
-
-    char line[128];
-    int ret = -1;
-    while (fgets(line, sizeof(line), fp))
-    {
-        char *colon = strchr(line, ':');
-        if (!colon) continue;
-
-        *colon = '\0';
-        char *n = line;
-        char *t = colon + 1;
-        t[strcspn(t, "\r\n")] = 0;
-
-        strncpy(name, n, namesz - 1);
-        name[namesz - 1] = '\0';
-        strncpy(type, t, typesz - 1);
-        type[typesz - 1] = '\0';
-        ret = 0;
-        break; // NOTE: first active connection only
-    }
-
-    fclose(fp);
-    waitpid(pid, NULL, 0);
-    return ret;
-}
+#define TRAY_STOP 1u
+#define TRAY_PAUSED 2u
 
-static int32_t get_cached_connection(char *name, size_t namesz, char *type,
-                                     size_t typesz)
+static void spark_push(spark_t *sp, uint32_t v, uint32_t max)
 {
-    static struct {
-        char name[32];
-        char type[16];
-        int result; // 0=connected, -1=disconnected
-        time_t last_update;
-    } cache = {.last_update = 0};
+    if (!max) return;
+    if (v > max) v = max;
 
-    time_t now = time(NULL);
-
-    // Cache hit (1 hour)
-    if (now - cache.last_update < 3600 && cache.last_update != 0)
-    {
-        strncpy(name, cache.name, namesz - 1);
-        name[namesz - 1] = '\0';
-        strncpy(type, cache.type, typesz - 1);
-        type[typesz - 1] = '\0';
-        return cache.result;
-    }
-
-    // Cache miss - call original
-    int32_t result = get_active_connection(name, namesz, type, typesz);
-
-    // Update cache
-    strncpy(cache.name, name, sizeof(cache.name) - 1);
-    cache.name[sizeof(cache.name) - 1] = '\0';
-    strncpy(cache.type, type, sizeof(cache.type) - 1);
-    cache.type[sizeof(cache.type) - 1] = '\0';
-    cache.result = result;
-    cache.last_update = now;
-
-    return result;
-}
-
-static int32_t update_connection(connection_t *conn)
-{
-    char name[32] = {0};
-    char type[16] = {0};
-    connect_state_t new_state = DISCONNECT;
-    connect_type_t new_type = UNKNOWN;
-
-    // NOTE: if not have network manager - this was become empty
-    // because relied connection from network manager since kernel not exposed
-    // wifi SSID to public (Network Manager already run on root previlage)
-    if (get_cached_connection(name, sizeof(name), type, sizeof(type)) == 0)
-    {
-        new_state = CONNECT;
-        if (strcmp(type, "802-11-wireless") == 0)
-        {
-            new_type = WIFI;
-        }
-        else if (strcmp(type, "ethernet") == 0)
-        {
-            new_type = LAN;
-        }
-        else
-        {
-            new_type = UNKNOWN;
-            new_state = DISCONNECT;
-        }
-    }
-
-    if (conn->cn_state != new_state)
-    {
-        conn->cn_state = new_state;
-        return 1;
-    }
-
-    if (conn->cn_type != new_type)
-    {
-        conn->cn_type = new_type;
-        return 1;
-    }
-
-    if (strcmp(conn->name, name) != 0)
-    {
-        if (strcmp(name, "lo") == 0)
-            conn->name[0] = '\0';
-        else
-            snprintf(conn->name, sizeof(conn->name), "%s", name);
-        return 1;
-    }
-
-    return 0;
+    sp->v[sp->head] = (uint8_t)(v * 255 / max);
+    sp->head = (uint8_t)((sp->head + 1) % SPARK_LEN);
+    if (sp->count < SPARK_LEN) sp->count++;
+    sp->gen++;
 }
 
 static int32_t update_workspace(qwm_t *wm, views_t *vw)
@@ -218,34 +104,20 @@ static int32_t update_cpu_freq(cpu_status_t *cpu)
     if (file_read_long(CPU_FREQ_PATH, &khz) < 0) return 0;
 
     int32_t mhz = (int)khz / 1000;
-    if (abs(mhz - cpu->mhz) >= 50)
-    {
-        cpu->mhz += (mhz - cpu->mhz) / 2;
-        return 1;
-    }
+    if (mhz > cpu->max_mhz) cpu->max_mhz = mhz;
 
-    return 0;
+    // every sample moves the graph, the text only follows big steps
+    spark_push(&cpu->hist, (uint32_t)mhz, (uint32_t)cpu->max_mhz);
+    if (abs(mhz - cpu->mhz) >= 50) cpu->mhz += (mhz - cpu->mhz) / 2;
+
+    return 1;
 }
 
 static void memory_init(memory_t *mem)
 {
-    FILE *f = fopen(MEMINFO_PATH, "r");
-    if (!f) return;
-
-    char key[32];
-    uint64_t value;
-    char unit[16];
-
-    while (fscanf(f, "%31s %lu %15s\n", key, &value, unit) == 3)
-    {
-        if (strcmp(key, "MemTotal:") == 0)
-        {
-            mem->total = (uint32_t)(value / 1024);
-            break;
-        }
-    }
-
-    fclose(f);
+    long kb;
+    if (file_read_key(MEMINFO_PATH, "MemTotal", &kb) == 0)
+        mem->total = (uint32_t)(kb / 1024);
 
     mem->current = 0;
     mem->last = 0;
@@ -258,81 +130,222 @@ static int32_t update_memory(memory_t *mem)
     if (now - mem->last_update < 30) return 0;
     mem->last_update = now;
 
-    FILE *f = fopen(MEMINFO_PATH, "r");
-    if (!f) return 0;
-
-    uint64_t value;
-    uint64_t available = 0;
-
-    char line[128];
-    while (fgets(line, sizeof(line), f))
-    {
-        if (sscanf(line, "MemAvailable: %lu", &value) == 1)
-        {
-            available = value;
-            break;
-        }
-    }
-    fclose(f);
+    long available = 0;
+    if (file_read_key(MEMINFO_PATH, "MemAvailable", &available) < 0)
+        return 0;
 
     if (!available || !mem->total) return 0;
     uint32_t used_mb = mem->total - (uint32_t)(available / 1024);
+    spark_push(&mem->hist, used_mb, mem->total);
     if (used_mb != mem->current)
     {
         mem->last = mem->current;
         mem->current = used_mb;
-        return 1;
     }
 
+    return 1;
+}
+
+/*****************************
+ * POWER SUPPLY
+ *****************************/
+
+// value of POWER_SUPPLY_<key> in a uevent file, it ends at '\n'
+static const char *uevent_get(const char *buf, const char *key)
+{
+    size_t klen = strlen(key);
+
+    for (const char *line = buf; line && *line; line = strchr(line, '\n'))
+    {
+        if (*line == '\n') line++;
+        if (strncmp(line, "POWER_SUPPLY_", 13) == 0 &&
+            strncmp(line + 13, key, klen) == 0 && line[13 + klen] == '=')
+            return line + 14 + klen;
+    }
+    return NULL;
+}
+
+static uint64_t uevent_num(const char *buf, const char *key)
+{
+    const char *v = uevent_get(buf, key);
+    return v ? strtoull(v, NULL, 10) : 0;
+}
+
+static int32_t value_is(const char *v, const char *s)
+{
+    size_t n = strlen(s);
+    return v && strncmp(v, s, n) == 0 && (v[n] == '\n' || v[n] == '\0');
+}
+
+// one read of the uevent file has every field
+static int32_t power_read(power_bat_t *b)
+{
+    char buf[1024];
+    if (file_read_all(b->path, buf, sizeof(buf)) < 0) return -1;
+
+    const char *st = uevent_get(buf, "STATUS");
+    b->state = value_is(st, "Charging")      ? BAT_CHARGING
+               : value_is(st, "Discharging") ? BAT_DISCHARGING
+               : value_is(st, "Full")        ? BAT_FULL
+                                             : BAT_UNKNOWN;
+    b->capacity = (uint8_t)uevent_num(buf, "CAPACITY");
+
+    if (uevent_get(buf, "ENERGY_NOW"))
+    {
+        b->energy_now = uevent_num(buf, "ENERGY_NOW");
+        b->energy_full = uevent_num(buf, "ENERGY_FULL");
+        b->power_now = uevent_num(buf, "POWER_NOW");
+        return 0;
+    }
+
+    // uAh and uA, times uV
+    uint64_t uv = uevent_num(buf, "VOLTAGE_NOW");
+    b->energy_now = uevent_num(buf, "CHARGE_NOW") * uv / 1000000;
+    b->energy_full = uevent_num(buf, "CHARGE_FULL") * uv / 1000000;
+    b->power_now = uevent_num(buf, "CURRENT_NOW") * uv / 1000000;
     return 0;
 }
 
-static int32_t update_battery_status(battery_t *bat)
+static void power_scan(power_t *pw)
 {
-    static time_t last_cap_check = 0;
-    static time_t last_status_check = 0;
-    time_t now = time(NULL);
+    pw->bat_count = 0;
+    pw->rescan = 0;
 
-    // Check capacity every 5 minutes
-    if (now - last_cap_check >= 300 || last_cap_check == 0)
+    DIR *d = opendir(POWER_SUPPLY_DIR);
+    if (!d) return;
+
+    struct dirent *e;
+    while ((e = readdir(d)) && pw->bat_count < POWER_MAX_BATS)
     {
-        last_cap_check = now;
-        int cap;
-        if (file_read_int(BAT_CAPACITY, &cap) == 0)
-        {
-            uint16_t new_cap = (uint16_t)cap;
-            if (new_cap != bat->capacity)
-            {
-                bat->capacity = new_cap;
-                return 1;
-            }
-        }
+        if (e->d_name[0] == '.') continue;
+
+        power_bat_t *b = &pw->bats[pw->bat_count];
+        int n = snprintf(b->path, sizeof(b->path),
+                         POWER_SUPPLY_DIR "/%s/uevent", e->d_name);
+        if (n < 0 || n >= (int)sizeof(b->path)) continue;
+
+        char buf[1024];
+        if (file_read_all(b->path, buf, sizeof(buf)) < 0) continue;
+
+        // mice and headsets have scope Device, they don't power us
+        if (!value_is(uevent_get(buf, "TYPE"), "Battery") ||
+            value_is(uevent_get(buf, "SCOPE"), "Device"))
+            continue;
+
+        pw->bat_count++;
+    }
+    closedir(d);
+}
+
+static void power_init(power_t *pw)
+{
+    power_scan(pw);
+
+    pw->uevent_fd =
+        socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+               NETLINK_KOBJECT_UEVENT);
+    if (pw->uevent_fd < 0) return;
+
+    // group 1 is the kernel's own events, udev rebroadcasts on 2
+    struct sockaddr_nl addr = {.nl_family = AF_NETLINK, .nl_groups = 1};
+    if (bind(pw->uevent_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(pw->uevent_fd);
+        pw->uevent_fd = -1;
     }
+}
+
+// drains the socket, flags power_supply events for the next collect
+static void power_uevent(power_t *pw)
+{
+    char buf[4096];
+    ssize_t n;
 
-    // Check status more often - every 10 seconds
-    if (now - last_status_check >= 10 || last_status_check == 0)
+    while ((n = recv(pw->uevent_fd, buf, sizeof(buf) - 1, 0)) > 0)
     {
-        last_status_check = now;
-        char buf[16];
-        if (file_read_string(BAT_STATUS, buf, sizeof(buf)) == 0)
+        buf[n] = '\0';
+
+        // "action@devpath\0KEY=value\0..."
+        int32_t ours = 0;
+        for (const char *k = buf + strlen(buf) + 1; k < buf + n;
+             k += strlen(k) + 1)
         {
-            battery_state_t new_state = BAT_UNKNOWN;
-            if (strcmp(buf, "Charging") == 0)
-                new_state = BAT_CHARGING;
-            else if (strcmp(buf, "Discharging") == 0)
-                new_state = BAT_DISCHARGING;
-            else if (strcmp(buf, "Full") == 0)
-                new_state = BAT_FULL;
-
-            if (new_state != bat->state)
-            {
-                bat->state = new_state;
-                return 1;
-            }
+            if (strcmp(k, "SUBSYSTEM=power_supply") == 0) ours = 1;
         }
+        if (!ours) continue;
+
+        pw->changed = 1;
+        if (strncmp(buf, "add@", 4) == 0 || strncmp(buf, "remove@", 7) == 0)
+            pw->rescan = 1;
+    }
+}
+
+static int32_t update_battery_status(battery_t *bat, power_t *pw)
+{
+    time_t now = time(NULL);
+    int32_t timed =
+        !pw->last_update || now - pw->last_update >= POWER_POLL_SEC;
+    if (!timed && !pw->changed) return 0;
+
+    if (timed) pw->last_update = now;
+    pw->changed = 0;
+    if (pw->rescan) power_scan(pw);
+
+    uint64_t energy = 0, full = 0, rate = 0;
+    uint32_t cap_sum = 0, count = 0, full_count = 0;
+    uint8_t charging = 0, discharging = 0;
+
+    for (uint32_t i = 0; i < pw->bat_count; ++i)
+    {
+        power_bat_t *b = &pw->bats[i];
+        if (power_read(b) < 0) continue;
+
+        count++;
+        cap_sum += b->capacity;
+        energy += b->energy_now;
+        full += b->energy_full;
+        rate += b->power_now;
+        charging |= b->state == BAT_CHARGING;
+        discharging |= b->state == BAT_DISCHARGING;
+        full_count += b->state == BAT_FULL;
     }
 
-    return 0;
+    uint16_t cap = full ? (uint16_t)(energy * 100 / full)
+                        : (uint16_t)(count ? cap_sum / count : 0);
+
+    // one charging battery means we are on AC
+    battery_state_t state = BAT_UNKNOWN;
+    if (charging)
+        state = BAT_CHARGING;
+    else if (discharging)
+        state = BAT_DISCHARGING;
+    else if (count && full_count == count)
+        state = BAT_FULL;
+
+    // the rate jumps with load, a quarter weight per minute evens it out
+    if (state != BAT_DISCHARGING)
+        pw->drain = 0;
+    else if (rate && (timed || !pw->drain))
+        pw->drain = pw->drain ? (3 * pw->drain + rate) / 4 : rate;
+
+    uint64_t tte = pw->drain ? energy * 60 / pw->drain : 0;
+    if (tte > UINT16_MAX) tte = UINT16_MAX;
+
+    int32_t changed = cap != bat->capacity || state != bat->state ||
+                      tte != bat->tte_min;
+    bat->capacity = cap;
+    bat->state = state;
+    bat->tte_min = (uint16_t)tte;
+
+    if (count && timed &&
+        (!bat->hist.count || ++pw->samples >= POWER_GRAPH_EVERY))
+    {
+        pw->samples = 0;
+        spark_push(&bat->hist, cap, 100);
+        changed = 1;
+    }
+
+    return changed;
 }
 
 static int32_t update_uptime(uptime_t *up)
@@ -360,24 +373,171 @@ static int32_t update_uptime(uptime_t *up)
 
 int32_t update_workspace_clients(struct qwm_t *wm, views_t *view)
 {
-    workspace_t *w = &wm->workspaces[wm->current_ws];
     uint16_t count = 0;
+    uint64_t key = 14695981039346656037ull;
 
-    for (client_t *c = w->clients; c; c = c->next) count++;
+    // every visible workspace has a bar listing its windows
+    for (uint16_t m = 0; m < MAX_MONITORS; ++m)
+    {
+        if (!wm->monitors[m].active) continue;
+
+        workspace_t *w = &wm->workspaces[wm->monitors[m].cur_ws];
+        for (client_t *c = w->clients; c; c = c->next)
+        {
+            count++;
+            key = (key ^ c->win ^ (uint64_t)(c == w->focused) << 32) *
+                  1099511628211ull;
+        }
+    }
 
-    if (view->client_count != count)
+    if (view->client_count != count || view->client_key != key)
     {
         view->client_count = count;
+        view->client_key = key;
         return 1;
     }
 
     return 0;
 }
 
+static int32_t metrics_collect(tray_worker_t *w)
+{
+    tray_metrics_t *m = &w->work;
+    int32_t changed = 0;
+
+    changed |= update_governor(&m->gov);
+    changed |= update_cpu_freq(&m->cpu);
+    changed |= update_memory(&m->mems);
+    changed |= update_battery_status(&m->bat, &w->power);
+    changed |= update_uptime(&m->up);
+
+    return changed;
+}
+
+static void metrics_show(tray_status_t *ts, const tray_metrics_t *m)
+{
+    ts->gov = m->gov;
+    ts->cpu = m->cpu;
+    ts->mems = m->mems;
+    ts->bat = m->bat;
+    ts->up = m->up;
+}
+
+/*****************************
+ * COLLECTOR THREAD
+ *****************************/
+
+static void fd_signal(int fd)
+{
+    uint64_t one = 1;
+    while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+}
+
+static void fd_drain(int fd)
+{
+    uint64_t n;
+    while (read(fd, &n, sizeof(n)) < 0 && errno == EINTR) {}
+}
+
+// the only writer, readers retry while seq is odd or moved
+static void worker_publish(tray_worker_t *w)
+{
+    uint32_t seq = __atomic_load_n(&w->seq, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&w->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&w->snap, &w->work, sizeof(w->snap));
+    __atomic_store_n(&w->seq, seq + 2, __ATOMIC_RELEASE);
+
+    fd_signal(w->wake_fd);
+}
+
+static void *worker_main(void *arg)
+{
+    tray_worker_t *w = arg;
+
+    for (;;)
+    {
+        uint32_t flags = __atomic_load_n(&w->flags, __ATOMIC_ACQUIRE);
+        if (flags & TRAY_STOP) break;
+
+        // collectors throttle themselves, a second is their finest step
+        int timeout = -1;
+        if (!(flags & TRAY_PAUSED))
+        {
+            if (metrics_collect(w)) worker_publish(w);
+            timeout = 1000;
+        }
+
+        struct pollfd pfd[2] = {
+            {.fd = w->kick_fd, .events = POLLIN},
+            {.fd = w->power.uevent_fd, .events = POLLIN},
+        };
+        nfds_t n = w->power.uevent_fd >= 0 ? 2 : 1;
+        if (poll(pfd, n, timeout) <= 0) continue;
+
+        if (pfd[0].revents & POLLIN) fd_drain(w->kick_fd);
+        if (n > 1 && (pfd[1].revents & POLLIN)) power_uevent(&w->power);
+    }
+    return NULL;
+}
+
+static void worker_start(tray_worker_t *w)
+{
+    w->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    w->kick_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (w->wake_fd >= 0 && w->kick_fd >= 0 &&
+        pthread_create(&w->thread, NULL, worker_main, w) == 0)
+    {
+        w->running = 1;
+        return;
+    }
+
+    if (w->wake_fd >= 0) close(w->wake_fd);
+    if (w->kick_fd >= 0) close(w->kick_fd);
+    w->wake_fd = -1;
+    w->kick_fd = -1;
+}
+
+/*****************************
+ * TRAY
+ *****************************/
+
 void tray_init(tray_status_t *ts)
 {
     memset(ts, 0, sizeof(*ts));
-    memory_init(&ts->mems);
+
+    tray_worker_t *w = &ts->worker;
+    memory_init(&w->work.mems);
+    power_init(&w->power);
+
+    long khz;
+    if (file_read_long(CPU_MAX_PATH, &khz) == 0)
+        w->work.cpu.max_mhz = (int)(khz / 1000);
+
+    worker_start(w);
+}
+
+void tray_kill(tray_status_t *ts)
+{
+    tray_worker_t *w = &ts->worker;
+
+    if (w->running)
+    {
+        __atomic_or_fetch(&w->flags, TRAY_STOP, __ATOMIC_RELEASE);
+        fd_signal(w->kick_fd);
+        pthread_join(w->thread, NULL);
+
+        close(w->wake_fd);
+        close(w->kick_fd);
+        w->wake_fd = -1;
+        w->kick_fd = -1;
+        w->running = 0;
+    }
+
+    if (w->power.uevent_fd >= 0) close(w->power.uevent_fd);
+    w->power.uevent_fd = -1;
 }
 
 int32_t tray_update(struct qwm_t *wm, tray_status_t *ts)
@@ -386,15 +546,49 @@ int32_t tray_update(struct qwm_t *wm, tray_status_t *ts)
 
     dirty |= update_workspace(wm, &ts->view);
     dirty |= update_workspace_clients(wm, &ts->view);
-
     dirty |= update_clock(&ts->time_date);
-    dirty |= update_governor(&ts->gov);
-    dirty |= update_cpu_freq(&ts->cpu);
-    dirty |= update_memory(&ts->mems);
-    dirty |= update_battery_status(&ts->bat);
-    dirty |= update_uptime(&ts->up);
-    dirty |= update_connection(&ts->connection);
+
+    tray_worker_t *w = &ts->worker;
+    if (!w->running && metrics_collect(w))
+    {
+        metrics_show(ts, &w->work);
+        dirty = 1;
+    }
 
     return dirty;
 }
 
+int32_t tray_collect(tray_status_t *ts)
+{
+    tray_worker_t *w = &ts->worker;
+    tray_metrics_t m;
+    uint32_t seq;
+
+    fd_drain(w->wake_fd);
+
+    do
+    {
+        seq = __atomic_load_n(&w->seq, __ATOMIC_ACQUIRE);
+        memcpy(&m, &w->snap, sizeof(m));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || __atomic_load_n(&w->seq, __ATOMIC_RELAXED) != seq);
+
+    if (seq == w->seen) return 0;
+    w->seen = seq;
+
+    metrics_show(ts, &m);
+    return 1;
+}
+
+void tray_pause(tray_status_t *ts, int32_t paused)
+{
+    tray_worker_t *w = &ts->worker;
+    if (!w->running || w->paused == !!paused) return;
+
+    w->paused = !!paused;
+    if (paused)
+        __atomic_or_fetch(&w->flags, TRAY_PAUSED, __ATOMIC_RELEASE);
+    else
+        __atomic_and_fetch(&w->flags, ~TRAY_PAUSED, __ATOMIC_RELEASE);
+    fd_signal(w->kick_fd);
+}
@@ -1,12 +1,34 @@
+/*
+ * Tray status
+ * Views and the clock are read on the X thread. Everything behind a file
+ * read runs on a collector thread, so a slow sysfs attribute never holds
+ * up event handling. It publishes tray_metrics_t snapshots under a
+ * seqlock and signals wake_fd only when a shown value changed; the X
+ * thread copies the snapshot out in tray_collect.
+ */
+
 #ifndef TRAY_STATUS_H
 #define TRAY_STATUS_H
 
 #include "views.h"
 
+#include <pthread.h>
+
+#define SPARK_LEN 32 // samples kept per history, one bar column each
+
+// fixed ring of recent samples, scaled to 0..255 of the metric's range
+typedef struct {
+    uint8_t v[SPARK_LEN];
+    uint8_t head; // next write
+    uint8_t count;
+    uint32_t gen; // samples pushed so far, a draw shifts by the difference
+} spark_t;
+
 typedef struct {
     layout_type_t last_layout;
     uint16_t last_workspace;
     uint16_t client_count;
+    uint64_t client_key; // order and focus of the listed windows
 } views_t;
 
 typedef struct {
@@ -21,7 +43,9 @@ typedef struct {
 
 typedef struct {
     int mhz;
+    int max_mhz; // cpuinfo_max_freq, else the highest sample seen
     time_t last_update;
+    spark_t hist;
 } cpu_status_t;
 
 typedef struct {
@@ -29,6 +53,7 @@ typedef struct {
     uint32_t current;
     uint32_t last;
     time_t last_update;
+    spark_t hist;
 } memory_t;
 
 typedef enum {
@@ -38,11 +63,37 @@ typedef enum {
     BAT_FULL
 } battery_state_t;
 
+// all batteries combined
 typedef struct {
     uint16_t capacity;
     battery_state_t state;
+    uint16_t tte_min; // time to empty, 0 unless discharging with a rate
+    spark_t hist;
 } battery_t;
 
+#define POWER_MAX_BATS 4
+
+typedef struct {
+    char path[80]; // its uevent file
+    battery_state_t state;
+    uint8_t capacity;
+    uint64_t energy_now; // uWh, charge_* converted with voltage_now
+    uint64_t energy_full;
+    uint64_t power_now; // uW
+} power_bat_t;
+
+// system batteries under /sys/class/power_supply, collector thread only
+typedef struct {
+    power_bat_t bats[POWER_MAX_BATS];
+    uint32_t bat_count;
+    int uevent_fd;   // NETLINK_KOBJECT_UEVENT, -1 without
+    uint8_t changed; // a power_supply uevent came in
+    uint8_t rescan;  // a supply was added or removed
+    uint8_t samples; // timed reads since the last graph sample
+    uint64_t drain;  // smoothed uW while discharging, 0 unknown
+    time_t last_update;
+} power_t;
+
 typedef struct {
     uint64_t current;
     uint64_t last;
@@ -62,10 +113,33 @@ typedef enum {
 typedef struct {
     connect_state_t cn_state;
     connect_type_t cn_type;
-    char name[32];
-    time_t last_update;
+    char name[33]; // SSID on Wi-Fi, interface name on LAN
 } connection_t;
 
+// everything read from sysfs and procfs, owned by the collector thread
+typedef struct {
+    governor_t gov;
+    cpu_status_t cpu;
+    memory_t mems;
+    battery_t bat;
+    uptime_t up;
+} tray_metrics_t;
+
+// collector thread, publishes work into snap under a seqlock
+typedef struct {
+    pthread_t thread;
+    uint8_t running; // 0: collected on the X thread in tray_update
+    uint8_t paused;
+    int wake_fd;    // eventfd, a new snapshot is out
+    int kick_fd;    // eventfd, flags changed
+    uint32_t flags; // TRAY_STOP, TRAY_PAUSED
+    uint32_t seq;   // odd while snap is written
+    uint32_t seen;  // seq of the last snapshot taken
+    tray_metrics_t snap;
+    tray_metrics_t work; // collector thread only
+    power_t power;       // collector thread only
+} tray_worker_t;
+
 typedef struct {
     views_t view;
     time_date_t time_date;
@@ -75,10 +149,21 @@ typedef struct {
     battery_t bat;
     uptime_t up;
     connection_t connection;
+    tray_worker_t worker;
 } tray_status_t;
 
+// starts the collector thread
 void tray_init(tray_status_t *ts);
 
+void tray_kill(tray_status_t *ts);
+
+// views and clock, the metrics too when there is no collector thread
 int32_t tray_update(struct qwm_t *wm, tray_status_t *ts);
 
+// wake_fd readable: takes the new snapshot, returns 1 when it was one
+int32_t tray_collect(tray_status_t *ts);
+
+// nothing shown, the collector thread sleeps until resumed
+void tray_pause(tray_status_t *ts, int32_t paused);
+
 #endif // TRAY_STATUS_H
@@ -1,31 +1,100 @@
+#ifndef _POSIX_C_SOURCE
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "util.h"
 
-#include <stdio.h>
-#include <stdlib.h>
+#include <errno.h>
 #include <string.h>
+#include <time.h>   // clock_gettime
+#include <fcntl.h>  // open, O_RDONLY, O_CLOEXEC
+#include <unistd.h> // pread, close
 
-static int file_read_line(const char *path, char *buf, size_t sz)
+#define FILE_CACHE_MAX 16
+
+static struct {
+    char path[96];
+    int fd;
+} file_cache[FILE_CACHE_MAX];
+static uint32_t file_cache_count;
+
+static int32_t file_cache_find(const char *path)
+{
+    for (uint32_t i = 0; i < file_cache_count; ++i)
+    {
+        if (strcmp(file_cache[i].path, path) == 0) return (int32_t)i;
+    }
+    return -1;
+}
+
+// whole file from offset 0 into buf, NUL terminated; -1 on error
+static int file_pread(const char *path, char *buf, size_t sz)
 {
-    FILE *f = fopen(path, "r");
-    if (!f) return -1;
+    int32_t slot = file_cache_find(path);
+    int fd =
+        slot >= 0 ? file_cache[slot].fd : open(path, O_RDONLY | O_CLOEXEC);
 
-    if (!fgets(buf, (int)sz, f))
+    // missing files are not cached, a battery may still show up
+    if (fd < 0) return -1;
+    if (slot < 0 && file_cache_count < FILE_CACHE_MAX &&
+        strlen(path) < sizeof(file_cache[0].path))
     {
-        fclose(f);
-        return -1;
+        slot = (int32_t)file_cache_count++;
+        strcpy(file_cache[slot].path, path);
+        file_cache[slot].fd = fd;
     }
 
-    fclose(f);
+    ssize_t n;
+    do
+        n = pread(fd, buf, sz - 1, 0);
+    while (n < 0 && errno == EINTR);
+
+    // an error drops the fd, a removed device is reopened next time
+    if (slot < 0 || n < 0)
+    {
+        close(fd);
+        if (slot >= 0) file_cache[slot] = file_cache[--file_cache_count];
+    }
+    if (n < 0) return -1;
+
+    buf[n] = 0;
+    return (int)n;
+}
+
+static int file_read_line(const char *path, char *buf, size_t sz)
+{
+    if (file_pread(path, buf, sz) < 0) return -1;
+
     buf[strcspn(buf, "\r\n")] = 0;
     return 0;
 }
 
+// decimal integer after optional blanks and sign, *end past the digits
+static int parse_long(const char *s, const char **end, long *out)
+{
+    while (*s == ' ' || *s == '\t') s++;
+
+    int neg = (*s == '-');
+    if (*s == '-' || *s == '+') s++;
+    if (*s < '0' || *s > '9') return -1;
+
+    long v = 0;
+    while (*s >= '0' && *s <= '9') v = v * 10 + (*s++ - '0');
+
+    *out = neg ? -v : v;
+    if (end) *end = s;
+    return 0;
+}
+
 int file_read_int(const char *path, int *out)
 {
     char buf[64];
+    long v;
     if (file_read_line(path, buf, sizeof(buf)) < 0) return -1;
+    if (parse_long(buf, NULL, &v) < 0) return -1;
 
-    return sscanf(buf, "%d", out) == 1 ? 0 : -1;
+    *out = (int)v;
+    return 0;
 }
 
 int file_read_long(const char *path, long *out)
@@ -35,23 +104,62 @@ int file_read_long(const char *path, long *out)
     char buf[64];
     if (file_read_line(path, buf, sizeof(buf)) < 0) return -1;
 
-    char *end = NULL;
-    long val = strtol(buf, &end, 10);
-    if (end == buf) return -1;
-
-    *out = val;
-    return 0;
+    return parse_long(buf, NULL, out);
 }
 
 int file_read_double(const char *path, double *out)
 {
     char buf[64];
+    const char *s;
+    long whole;
     if (file_read_line(path, buf, sizeof(buf)) < 0) return -1;
+    if (parse_long(buf, &s, &whole) < 0) return -1;
 
-    return sscanf(buf, "%lf", out) == 1 ? 0 : -1;
+    // fraction digits only, the /proc values have no exponent
+    int neg = buf[strspn(buf, " \t")] == '-';
+    double v = (double)(neg ? -whole : whole);
+    if (*s == '.')
+    {
+        double scale = 0.1;
+        for (s++; *s >= '0' && *s <= '9'; s++, scale *= 0.1)
+            v += (*s - '0') * scale;
+    }
+
+    *out = neg ? -v : v;
+    return 0;
 }
 
 int file_read_string(const char *path, char *buf, size_t sz)
 {
     return file_read_line(path, buf, sz);
 }
+
+int file_read_all(const char *path, char *buf, size_t sz)
+{
+    return file_pread(path, buf, sz);
+}
+
+int file_read_key(const char *path, const char *key, long *out)
+{
+    char buf[4096];
+    if (file_pread(path, buf, sizeof(buf)) < 0) return -1;
+
+    size_t klen = strlen(key);
+    for (const char *line = buf; *line;)
+    {
+        if (strncmp(line, key, klen) == 0 && line[klen] == ':')
+            return parse_long(line + klen + 1, NULL, out);
+
+        line = strchr(line, '\n');
+        if (!line) break;
+        line++;
+    }
+    return -1;
+}
+
+uint64_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
@@ -1,7 +1,16 @@
+/*
+ * File sampling helpers
+ * Each path is opened once and kept open; every read is a single pread
+ * from offset 0 into a stack buffer, which sysfs and procfs answer with
+ * fresh contents. Not thread safe: after tray_init only the tray collector
+ * thread calls these.
+ */
+
 #ifndef UTIL_H
 #define UTIL_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 int file_read_int(const char *path, int *out);
 
@@ -11,4 +20,12 @@ int file_read_double(const char *path, double *out);
 
 int file_read_string(const char *path, char *buf, size_t sz);
 
+// whole file, NUL terminated, returns its length
+int file_read_all(const char *path, char *buf, size_t sz);
+
+// value of a "key: value" line, as in /proc/meminfo
+int file_read_key(const char *path, const char *key, long *out);
+
+uint64_t monotonic_ms(void);
+
 #endif // UTIL_H
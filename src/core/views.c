@@ -1,61 +1,123 @@
 #include "views.h"
 #include "qwm.h"
 
-#define MIN_W 100
-#define MIN_H 100
+#include <stdlib.h>
 
 #define BW BORDER_WIDTH
-#define BAR wm->taskbar.height
 
-static uint16_t count_clients(client_t *c)
+static uint16_t count_clients(const client_t *c)
 {
     uint16_t n = 0;
     for (; c; c = c->next) n++;
     return n;
 }
 
-static void set_layout_stack(qwm_t *wm, client_t *c, uint32_t x, uint32_t y,
-                             uint32_t total_w, uint32_t total_h,
-                             uint16_t stack_n, uint8_t vertical)
+static uint16_t count_tiled(const client_t *c)
+{
+    uint16_t n = 0;
+    for (; c; c = c->next) n += !c->floating;
+    return n;
+}
+
+static void set_geom(geom_t *g, uint32_t x, uint32_t y, uint32_t w,
+                     uint32_t h)
+{
+    g->x = x;
+    g->y = y;
+    g->w = w;
+    g->h = h;
+    g->hidden = 0;
+}
+
+// A stack that no longer fits at MIN_W/MIN_H overflows into more lanes
+// (columns for a vertical stack, rows otherwise). Past a full screen of
+// lanes it pages: only the page holding `anchor` is laid out, the rest
+// are marked hidden. c/idx is the first stack client and its list index,
+// floating clients in between are skipped.
+static void set_layout_stack(geom_t *out, const client_t *c, uint16_t idx,
+                             uint32_t x, uint32_t y, uint32_t total_w,
+                             uint32_t total_h, uint16_t stack_n,
+                             uint16_t anchor, uint8_t vertical)
 {
     if (stack_n == 0) return;
 
-    uint32_t step = vertical ? total_h / stack_n : total_w / stack_n;
-    if (vertical && step < MIN_H) step = MIN_H;
-    if (!vertical && step < MIN_W) step = MIN_W;
+    uint32_t along = vertical ? total_h : total_w;
+    uint32_t across = vertical ? total_w : total_h;
+
+    uint32_t per_lane = along / (vertical ? MIN_H : MIN_W);
+    uint32_t max_lanes = across / (vertical ? MIN_W : MIN_H);
+    if (per_lane == 0) per_lane = 1;
+    if (max_lanes == 0) max_lanes = 1;
 
-    for (; c; c = c->next)
+    uint32_t page = per_lane * max_lanes;
+    uint32_t first = 0;
+    uint32_t count = stack_n;
+
+    if (stack_n > page)
     {
+        if (anchor >= stack_n) anchor = stack_n - 1;
+        first = anchor / page * page;
+        count = stack_n - first < page ? stack_n - first : page;
+    }
+
+    uint32_t lanes = (count + per_lane - 1) / per_lane;
+    uint32_t lane_len = (count + lanes - 1) / lanes;
+    uint32_t lane_size = across / lanes;
+
+    uint32_t i = 0;
+    for (; c; c = c->next, ++idx)
+    {
+        if (c->floating) continue;
+
+        uint32_t pos = i++;
+        if (pos < first || pos >= first + count)
+        {
+            out[idx].hidden = 1;
+            continue;
+        }
+
+        uint32_t k = pos - first;
+        uint32_t lane = k / lane_len;
+        uint32_t in_lane = count - lane * lane_len;
+        if (in_lane > lane_len) in_lane = lane_len;
+
+        uint32_t step = along / in_lane;
+        uint32_t a = (k % lane_len) * step;
+        uint32_t b = lane * lane_size;
+
         if (vertical)
         {
-            client_configure(wm, c, x + BW - 1, y + BW - 1, total_w - 3 * BW,
-                             step - 3 * BW);
-            y += step;
+            set_geom(&out[idx], x + b + BW - 1, y + a + BW - 1,
+                     lane_size - 3 * BW, step - 3 * BW);
         }
         else
         {
-            client_configure(wm, c, x + BW - 1, y + BW - 1, step - 3 * BW,
-                             total_h - 3 * BW);
-            x += step;
+            set_geom(&out[idx], x + a + BW - 1, y + b + BW - 1,
+                     step - 3 * BW, lane_size - 3 * BW);
         }
     }
 }
 
-static void layout_tile(struct qwm_t *wm, uint16_t ws, uint8_t vertical)
+static void layout_tile(const workspace_t *w, const geom_t *m, uint32_t bar_h,
+                        geom_t *out)
 {
-    workspace_t *w = &wm->workspaces[ws];
-    if (!w->clients) return;
+    uint32_t ox = m->x;
+    uint32_t oy = m->y;
+    uint32_t full_w = m->w;
+    uint32_t full_h = m->h - bar_h;
 
-    uint32_t full_w = wm->w;
-    uint32_t full_h = wm->h - wm->taskbar.height;
-    if (full_w < MIN_W || full_h < MIN_H) return;
+    // master is the first tiled client
+    const client_t *c = w->clients;
+    uint16_t idx = 0;
+    for (; c && c->floating; c = c->next) idx++;
+    if (!c) return;
 
-    client_t *c = w->clients;
-    uint16_t n = count_clients(c);
+    uint8_t vertical = w->vertical;
+    uint16_t n = count_tiled(c);
     if (n == 1)
     {
-        client_configure(wm, c, BW - 1, BW - 1, full_w - 3 * BW,
-                         full_h - 3 * BW);
+        set_geom(&out[idx], ox + BW - 1, oy + BW - 1, full_w - 3 * BW,
+                 full_h - 3 * BW);
         return;
     }
 
@@ -65,79 +127,196 @@ static void layout_tile(struct qwm_t *wm, uint16_t ws, uint8_t vertical)
     if (master_w < MIN_W) master_w = full_w;
     if (master_h < MIN_H) master_h = full_h;
 
-    client_configure(wm, c, BW - 1, BW - 1, master_w - 3 * BW,
-                     master_h - 3 * BW);
+    set_geom(&out[idx], ox + BW - 1, oy + BW - 1, master_w - 3 * BW,
+             master_h - 3 * BW);
 
     // stack windows
-    c = c->next;
     if (vertical)
     {
-        set_layout_stack(wm, c, master_w, 0, full_w - master_w, full_h, n - 1,
+        set_layout_stack(out, c->next, idx + 1, ox + master_w, oy,
+                         full_w - master_w, full_h, n - 1, w->stack_anchor,
                          1);
+        return;
+    }
+    set_layout_stack(out, c->next, idx + 1, ox, oy + master_h, full_w,
+                     full_h - master_h, n - 1, w->stack_anchor, 0);
+}
+
+static void layout_monocle(const workspace_t *w, const geom_t *m,
+                           uint32_t bar_h, geom_t *out)
+{
+    uint32_t x = m->x + BW - 1;
+    uint32_t y = m->y + BW - 1;
+    uint32_t width = m->w - 3 * BW;
+    uint32_t height = m->h - bar_h - 3 * BW;
+
+    // only the focused tiled client stays mapped, the rest stop
+    // rendering; floating ones (dialogs, scratchpad) stay up on top
+    const client_t *shown = w->focused;
+    if (!shown || shown->floating)
+    {
+        for (shown = w->clients; shown && shown->floating;)
+            shown = shown->next;
     }
-    else
+
+    uint16_t n = 0;
+    for (const client_t *c = w->clients; c; c = c->next, ++n)
     {
-        set_layout_stack(wm, c, 0, master_h, full_w, full_h - master_h, n - 1,
-                         0);
+        if (c->floating) continue;
+
+        set_geom(&out[n], x, y, width, height);
+        out[n].hidden = (c != shown);
     }
 }
 
-static void layout_monocle(struct qwm_t *wm, uint16_t ws)
+static uint16_t layout_floating(const workspace_t *w, const geom_t *m,
+                                uint32_t bar_h, geom_t *out)
 {
-    workspace_t *w = &wm->workspaces[ws];
-    if (!w->clients) return;
+    uint32_t area_h = m->h > bar_h ? m->h - bar_h : m->h;
+    uint32_t screen_w = m->w > 2 * BW ? m->w - 2 * BW : m->w;
+    uint32_t screen_h = area_h > 2 * BW ? area_h - 2 * BW : area_h;
 
-    uint32_t x = BW - 1;
-    uint32_t y = BW - 1;
-    uint32_t width = wm->w - 3 * BW;
-    uint32_t height = wm->h - BAR - 3 * BW;
+    uint16_t n = 0;
+    for (const client_t *c = w->clients; c; c = c->next)
+    {
+        // requested size, or 60% of the output when it didn't ask
+        uint32_t win_w = c->fw ? c->fw : screen_w * 6 / 10;
+        uint32_t win_h = c->fh ? c->fh : screen_h * 6 / 10;
 
-    if (width < MIN_W || height < MIN_H) return;
+        if (win_w < MIN_W) win_w = MIN_W;
+        if (win_h < MIN_H) win_h = MIN_H;
+        if (win_w > screen_w) win_w = screen_w;
+        if (win_h > screen_h) win_h = screen_h;
 
-    uint32_t values[] = {x, y, width, height};
-    uint16_t mask = XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y |
-                    XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT;
+        uint32_t min_x = m->x;
+        uint32_t min_y = m->y;
+        uint32_t max_x = min_x + m->w - win_w - 2 * BW;
+        uint32_t max_y = min_y + area_h - win_h - 2 * BW;
 
-    for (client_t *c = w->clients; c; c = c->next)
-        xcb_configure_window(wm->conn, c->win, mask, values);
+        // keep windows on their own output, e.g. after an unplug
+        uint32_t x = c->fx < min_x ? min_x : c->fx > max_x ? max_x : c->fx;
+        uint32_t y = c->fy < min_y ? min_y : c->fy > max_y ? max_y : c->fy;
+
+        set_geom(&out[n++], x, y, win_w, win_h);
+    }
+    return n;
 }
 
-static void layout_floating(struct qwm_t *wm, uint16_t ws)
+uint16_t layout_compute(const workspace_t *w, const geom_t *mon,
+                        uint32_t bar_h, geom_t *out)
 {
-    workspace_t *w = &wm->workspaces[ws];
-    if (!w->clients) return;
+    if (!w->clients) return 0;
+    if (mon->w < MIN_W || mon->h - bar_h < MIN_H) return 0;
 
-    uint32_t screen_w = wm->w > 2 * BW ? wm->w - 2 * BW : wm->w;
-    uint32_t screen_h = wm->h > 2 * BW ? wm->h - 2 * BW : wm->h;
+    // every client starts out floating, tiled ones are overwritten below
+    uint16_t n = layout_floating(w, mon, bar_h, out);
 
-    uint32_t win_w = screen_w * 6 / 10;
-    uint32_t win_h = screen_h * 6 / 10;
+    switch (w->type)
+    {
+    case LAYOUT_MONOCLE: layout_monocle(w, mon, bar_h, out); break;
+    case LAYOUT_FLOAT: break;
+    case LAYOUT_TILE: layout_tile(w, mon, bar_h, out); break;
+    }
 
-    if (win_w < MIN_W) win_w = MIN_W;
-    if (win_h < MIN_H) win_h = MIN_H;
-    if (win_w > wm->w) win_w = wm->w;
-    if (win_h > wm->h) win_h = wm->h;
+    // fullscreen clients take the whole output, bar area and all
+    uint16_t i = 0;
+    for (const client_t *c = w->clients; c && i < n; c = c->next, ++i)
+    {
+        if (!c->fullscreen) continue;
 
-    for (client_t *c = w->clients; c; c = c->next)
+        uint8_t hidden = out[i].hidden;
+        set_geom(&out[i], mon->x, mon->y, mon->w, mon->h);
+        out[i].hidden = hidden;
+    }
+    return n;
+}
+
+// only windows whose geometry or mapping changed since the last
+// submission get a request
+static void layout_submit(struct qwm_t *wm, uint16_t ws, const geom_t *g,
+                          uint16_t n)
+{
+    int32_t visible = monitor_ws_visible(wm, ws);
+    uint16_t i = 0;
+
+    for (client_t *c = wm->workspaces[ws].clients; c; c = c->next, ++i)
     {
-        uint32_t x = c->x;
-        uint32_t y = c->y;
+        if (i >= n)
+        {
+            client_show(wm, c, visible);
+            continue;
+        }
+
+        if (g[i].hidden)
+        {
+            client_show(wm, c, 0);
+            continue;
+        }
+
+        if (c->x != g[i].x || c->y != g[i].y || c->w != g[i].w ||
+            c->h != g[i].h)
+            client_configure(wm, c, g[i].x, g[i].y, g[i].w, g[i].h);
 
-        uint32_t v[] = {x, y, win_w, win_h};
-        uint16_t mask = XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y |
-                        XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT;
-        xcb_configure_window(wm->conn, c->win, mask, v);
+        client_show(wm, c, visible);
     }
 }
 
-void layout_apply(struct qwm_t *wm, uint16_t ws)
+// the stack page follows focus, focusing the master (or a floating
+// client) keeps the page
+static void update_stack_anchor(workspace_t *w)
 {
-    workspace_t *w = &wm->workspaces[ws];
+    if (!w->focused || w->focused->floating) return;
 
-    switch (w->type)
+    uint16_t i = 0;
+    for (client_t *c = w->clients; c; c = c->next)
     {
-    case LAYOUT_MONOCLE: layout_monocle(wm, ws); break;
-    case LAYOUT_FLOAT: layout_floating(wm, ws); break;
-    case LAYOUT_TILE: layout_tile(wm, ws, w->vertical); break;
+        if (c == w->focused)
+        {
+            if (i > 0) w->stack_anchor = (uint16_t)(i - 1);
+            return;
+        }
+        i += !c->floating;
     }
 }
+
+static int32_t layout_reserve(struct qwm_t *wm, uint16_t n)
+{
+    if (n <= wm->layout_cap) return 1;
+
+    uint16_t cap = wm->layout_cap ? wm->layout_cap : 16;
+    while (cap < n) cap *= 2;
+
+    geom_t *geom = realloc(wm->layout_geom, cap * sizeof(geom_t));
+    if (!geom) return 0;
+
+    wm->layout_geom = geom;
+    wm->layout_cap = cap;
+    return 1;
+}
+
+void layout_apply(struct qwm_t *wm, uint16_t ws)
+{
+    workspace_t *w = &wm->workspaces[ws];
+    monitor_t *m = monitor_of_ws(wm, ws);
+    if (!m->active || !w->clients) return;
+
+    if (!layout_reserve(wm, count_clients(w->clients))) return;
+
+    update_stack_anchor(w);
+    place_workspace(wm, ws);
+
+    geom_t area = {(uint32_t)m->x, (uint32_t)m->y, m->w, m->h, 0};
+    uint16_t n = layout_compute(w, &area, m->taskbar.height, wm->layout_geom);
+
+    layout_submit(wm, ws, wm->layout_geom, n);
+}
+
+void layout_kill(struct qwm_t *wm)
+{
+    for (uint16_t ws = 0; ws < WORKSPACE_TOTAL; ++ws)
+        place_kill(&wm->workspaces[ws].place);
+
+    free(wm->layout_geom);
+    wm->layout_geom = NULL;
+    wm->layout_cap = 0;
+}
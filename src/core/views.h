@@ -2,10 +2,20 @@
 #define VIEWS_H
 
 #include "client.h"
+#include "place.h"
 
 struct qwm_t;
 
-#define WORKSPACE_COUNT 5
+#define MAX_MONITORS 4
+#define WORKSPACE_COUNT 5 // per monitor
+
+#define MIN_W 100
+#define MIN_H 100
+#define WORKSPACE_TOTAL (MAX_MONITORS * WORKSPACE_COUNT)
+
+// workspaces are stored flat, monitor m owns a block of WORKSPACE_COUNT
+#define WS_MONITOR(ws) ((uint16_t)((ws) / WORKSPACE_COUNT))
+#define WS_NUMBER(ws) ((uint16_t)((ws) % WORKSPACE_COUNT))
 
 typedef enum {
     LAYOUT_MONOCLE,
@@ -13,13 +23,27 @@ typedef enum {
     LAYOUT_TILE,
 } layout_type_t;
 
+typedef struct {
+    uint32_t x, y, w, h;
+    uint8_t hidden; // unmapped, e.g. on another stack page
+} geom_t;
+
 typedef struct {
     client_t *clients;
     client_t *focused;
     layout_type_t type;
     uint8_t vertical;
+    uint16_t stack_anchor; // last focused stack index, picks the stack page
+    place_t place;         // floating occupancy, built on first use
 } workspace_t;
 
+// no X calls: fills out[i] for the i-th client of w, in list order, and
+// returns how many entries were written (0 leaves every client untouched)
+uint16_t layout_compute(const workspace_t *w, const geom_t *mon,
+                        uint32_t bar_h, geom_t *out);
+
 void layout_apply(struct qwm_t *wm, uint16_t ws);
 
+void layout_kill(struct qwm_t *wm);
+
 #endif // VIEWS_H
@@ -0,0 +1,236 @@
+/*
+ * Taskbar rasterizer micro benchmark
+ * cc -std=c99 -O2 tests/bench_raster.c -o bench_raster -lxcb -lxcb-shm
+ * ./bench_raster
+ *
+ * Times one full bar frame through raster.c: background fill, every
+ * segment's text and the PutImage pack. No X needed for that part.
+ *
+ * With a display it also times the same frame end to end against the
+ * core-font path taskbar_draw uses without USE_SHM_BAR (fill, PolyText8
+ * and CopyArea from a pixmap), one round trip per frame:
+ * Xvfb :99 -screen 0 1920x1080x24 & DISPLAY=:99 ./bench_raster
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+// the rasterizer is compiled out by default, config.h is guarded
+#include "../src/config.h"
+#undef USE_SHM_BAR
+#define USE_SHM_BAR 1
+
+#include "../src/core/raster.c"
+
+#include <stdio.h>
+#include <time.h>
+
+#define CPU_ITERATIONS 20000
+#define X_ITERATIONS 2000
+
+#define BAR_W 1920
+#define BAR_H 24
+#define BAR_BG 0x444444
+#define BAR_FG 0xDDDDDD
+
+// what a busy bar shows, x positions as the taskbar lays them out
+static const struct {
+    int16_t x;
+    const char *text;
+} segs[] = {
+    {8, "qwm"},
+    {32, "| WS1 (3)"},
+    {120, "kitty - ~/src/qwm: vim src/core/raster.c"},
+    {1180, "2400 MHz"},
+    {1250, "performance"},
+    {1350, "3.1/15.6 GB"},
+    {1450, "wlan0 home-wifi"},
+    {1580, "BAT 87% (dis 4h12m)"},
+    {1740, "up 3h12m"},
+    {1830, "12:34"},
+};
+
+#define SEG_N (sizeof(segs) / sizeof(segs[0]))
+
+/*****************************
+ * BENCH
+ *****************************/
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t ns, uint32_t iterations)
+{
+    printf("%-28s %9.0f ns/frame\n", name, (double)ns / iterations);
+}
+
+static void raster_frame(raster_t *r)
+{
+    raster_fill(r, 0, 0, r->w, r->h, BAR_BG);
+    for (uint32_t i = 0; i < SEG_N; ++i)
+    {
+        raster_text(r, segs[i].x, 16, segs[i].text,
+                    (uint32_t)strlen(segs[i].text), BAR_FG);
+    }
+}
+
+static void bench_cpu(void)
+{
+    raster_t r = {.w = BAR_W, .h = BAR_H};
+    r.pixels = malloc((size_t)BAR_W * BAR_H * 4);
+    uint32_t *pack = malloc((size_t)BAR_W * BAR_H * 4);
+    if (!r.pixels || !pack) return;
+
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < CPU_ITERATIONS; ++i)
+        raster_fill(&r, 0, 0, r.w, r.h, BAR_BG);
+    uint64_t t_fill = now_ns() - t0;
+
+    t0 = now_ns();
+    for (int i = 0; i < CPU_ITERATIONS; ++i) raster_frame(&r);
+    uint64_t t_draw = now_ns() - t0;
+
+    t0 = now_ns();
+    for (int i = 0; i < CPU_ITERATIONS; ++i)
+    {
+        raster_frame(&r);
+        pack_span(&r, 0, BAR_W, pack);
+    }
+    uint64_t t_pack = now_ns() - t0;
+
+    // also keeps the stores from being optimized away
+    uint32_t lit = 0;
+    for (uint32_t i = 0; i < (uint32_t)BAR_W * BAR_H; ++i)
+        lit += pack[i] == BAR_FG;
+    printf("%dx%d bar, %u text pixels\n", BAR_W, BAR_H, lit);
+    report("raster fill", t_fill, CPU_ITERATIONS);
+    report("raster fill + text", t_draw, CPU_ITERATIONS);
+    report("raster fill + text + pack", t_pack, CPU_ITERATIONS);
+
+    free(pack);
+    free(r.pixels);
+}
+
+// one round trip, the server has executed everything sent before it
+static void sync_server(xcb_connection_t *conn)
+{
+    free(xcb_get_input_focus_reply(conn, xcb_get_input_focus(conn), NULL));
+}
+
+static void bench_core(struct qwm_t *wm, xcb_window_t win)
+{
+    xcb_connection_t *conn = wm->conn;
+
+    xcb_font_t font = xcb_generate_id(conn);
+    xcb_open_font(conn, font, strlen(FONT), FONT);
+
+    xcb_pixmap_t pix = xcb_generate_id(conn);
+    xcb_create_pixmap(conn, wm->screen->root_depth, pix, win, BAR_W, BAR_H);
+
+    uint32_t fg[] = {BAR_FG, BAR_BG, font};
+    xcb_gcontext_t gc = xcb_generate_id(conn);
+    xcb_create_gc(conn, gc, win,
+                  XCB_GC_FOREGROUND | XCB_GC_BACKGROUND | XCB_GC_FONT, fg);
+
+    uint32_t bg = BAR_BG;
+    xcb_gcontext_t bg_gc = xcb_generate_id(conn);
+    xcb_create_gc(conn, bg_gc, win, XCB_GC_FOREGROUND, &bg);
+
+    xcb_rectangle_t all = {0, 0, BAR_W, BAR_H};
+    uint8_t item[2 + 254];
+
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < X_ITERATIONS; ++i)
+    {
+        xcb_poly_fill_rectangle(conn, pix, bg_gc, 1, &all);
+        for (uint32_t s = 0; s < SEG_N; ++s)
+        {
+            // one TEXTITEM8: length, delta, string
+            size_t len = strlen(segs[s].text);
+            item[0] = (uint8_t)len;
+            item[1] = 0;
+            memcpy(item + 2, segs[s].text, len);
+            xcb_poly_text_8(conn, pix, gc, segs[s].x, 16,
+                            (uint32_t)(2 + len), item);
+        }
+        xcb_copy_area(conn, pix, win, gc, 0, 0, 0, 0, BAR_W, BAR_H);
+        sync_server(conn);
+    }
+    report("core font frame (X)", now_ns() - t0, X_ITERATIONS);
+
+    xcb_free_gc(conn, bg_gc);
+    xcb_free_gc(conn, gc);
+    xcb_free_pixmap(conn, pix);
+    xcb_close_font(conn, font);
+}
+
+static void bench_raster(struct qwm_t *wm, xcb_window_t win)
+{
+    xcb_connection_t *conn = wm->conn;
+    raster_t r;
+
+    raster_setup(wm);
+    if (!raster_init(wm, &r, BAR_W, BAR_H))
+    {
+        printf("raster: screen is not 24 bit TrueColor, skipped\n");
+        return;
+    }
+
+    xcb_gcontext_t gc = xcb_generate_id(conn);
+    xcb_create_gc(conn, gc, win, 0, NULL);
+
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < X_ITERATIONS; ++i)
+    {
+        raster_frame(&r);
+        raster_put(wm, &r, win, gc, 0, BAR_W);
+        sync_server(conn);
+
+        // the segment is free again once the put has been executed
+        xcb_generic_event_t *ev;
+        while ((ev = xcb_poll_for_event(conn))) free(ev);
+        raster_done(&r);
+    }
+    uint64_t t_put = now_ns() - t0;
+    report(r.shmseg ? "raster frame (ShmPutImage)" : "raster frame (PutImage)",
+           t_put, X_ITERATIONS);
+
+    xcb_free_gc(conn, gc);
+    raster_kill(wm, &r);
+}
+
+int main(void)
+{
+    bench_cpu();
+
+    static struct qwm_t wm;
+    wm.conn = xcb_connect(NULL, NULL);
+    if (xcb_connection_has_error(wm.conn))
+    {
+        printf("no display, X comparison skipped\n");
+        xcb_disconnect(wm.conn);
+        return 0;
+    }
+    wm.setup = xcb_get_setup(wm.conn);
+    wm.screen = xcb_setup_roots_iterator(wm.setup).data;
+    wm.root = wm.screen->root;
+
+    xcb_window_t win = xcb_generate_id(wm.conn);
+    uint32_t values[] = {1};
+    xcb_create_window(wm.conn, XCB_COPY_FROM_PARENT, win, wm.root, 0, 0,
+                      BAR_W, BAR_H, 0, XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                      wm.screen->root_visual, XCB_CW_OVERRIDE_REDIRECT,
+                      values);
+    xcb_map_window(wm.conn, win);
+    sync_server(wm.conn);
+
+    bench_core(&wm, win);
+    bench_raster(&wm, win);
+
+    xcb_destroy_window(wm.conn, win);
+    xcb_disconnect(wm.conn);
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * file_read_* micro benchmark, no X needed
+ * cc -std=c99 -O2 tests/bench_util.c -o bench_util && ./bench_util
+ *
+ * Times the old fopen/fgets/sscanf readers against the cached pread and
+ * hand-written scanners in src/core/util.c, on /proc/meminfo and a sysfs
+ * attribute (cpufreq when present, else /sys/kernel/mm/.../enabled).
+ */
+
+#include "../src/core/util.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ITERATIONS 100000
+
+#define MEMINFO_PATH "/proc/meminfo"
+#define SYSFS_FREQ "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq"
+#define SYSFS_FALLBACK "/sys/kernel/mm/transparent_hugepage/enabled"
+
+/*****************************
+ * OLD READERS
+ *****************************/
+
+static int old_read_line(const char *path, char *buf, size_t sz)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    if (!fgets(buf, (int)sz, f))
+    {
+        fclose(f);
+        return -1;
+    }
+
+    fclose(f);
+    buf[strcspn(buf, "\r\n")] = 0;
+    return 0;
+}
+
+static int old_read_long(const char *path, long *out)
+{
+    char buf[64];
+    if (old_read_line(path, buf, sizeof(buf)) < 0) return -1;
+
+    char *end = NULL;
+    long val = strtol(buf, &end, 10);
+    if (end == buf) return -1;
+
+    *out = val;
+    return 0;
+}
+
+static int old_read_string(const char *path, char *buf, size_t sz)
+{
+    return old_read_line(path, buf, sz);
+}
+
+static int old_meminfo(long *out)
+{
+    FILE *f = fopen(MEMINFO_PATH, "r");
+    if (!f) return -1;
+
+    long value;
+    int ret = -1;
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "MemAvailable: %ld", &value) == 1)
+        {
+            *out = value;
+            ret = 0;
+            break;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+/*****************************
+ * BENCH
+ *****************************/
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t old_ns, uint64_t new_ns)
+{
+    printf("%-24s old %7.0f ns  new %7.0f ns  %5.2fx\n", name,
+           (double)old_ns / ITERATIONS, (double)new_ns / ITERATIONS,
+           new_ns ? (double)old_ns / (double)new_ns : 0.0);
+}
+
+int main(void)
+{
+    long a = 0, b = 0;
+    uint64_t t0, t_old, t_new;
+
+    // same answers first, a fast wrong reader proves nothing
+    if (old_meminfo(&a) < 0 ||
+        file_read_key(MEMINFO_PATH, "MemAvailable", &b) < 0)
+    {
+        fprintf(stderr, "%s unreadable\n", MEMINFO_PATH);
+        return 1;
+    }
+    printf("MemAvailable old %ld kB new %ld kB\n", a, b);
+
+    t0 = now_ns();
+    for (int i = 0; i < ITERATIONS; ++i) old_meminfo(&a);
+    t_old = now_ns() - t0;
+
+    t0 = now_ns();
+    for (int i = 0; i < ITERATIONS; ++i)
+        file_read_key(MEMINFO_PATH, "MemAvailable", &b);
+    t_new = now_ns() - t0;
+    report("meminfo MemAvailable", t_old, t_new);
+
+    if (old_read_long(SYSFS_FREQ, &a) == 0)
+    {
+        file_read_long(SYSFS_FREQ, &b);
+        printf("scaling_cur_freq old %ld new %ld\n", a, b);
+
+        t0 = now_ns();
+        for (int i = 0; i < ITERATIONS; ++i) old_read_long(SYSFS_FREQ, &a);
+        t_old = now_ns() - t0;
+
+        t0 = now_ns();
+        for (int i = 0; i < ITERATIONS; ++i) file_read_long(SYSFS_FREQ, &b);
+        t_new = now_ns() - t0;
+        report("sysfs file_read_long", t_old, t_new);
+        return 0;
+    }
+
+    // no cpufreq (VMs, containers), any short sysfs attribute will do
+    char s1[128], s2[128];
+    if (old_read_string(SYSFS_FALLBACK, s1, sizeof(s1)) < 0)
+    {
+        printf("no sysfs attribute to time\n");
+        return 0;
+    }
+    file_read_string(SYSFS_FALLBACK, s2, sizeof(s2));
+    printf("%s\n  old \"%s\"\n  new \"%s\"\n", SYSFS_FALLBACK, s1, s2);
+
+    t0 = now_ns();
+    for (int i = 0; i < ITERATIONS; ++i)
+        old_read_string(SYSFS_FALLBACK, s1, sizeof(s1));
+    t_old = now_ns() - t0;
+
+    t0 = now_ns();
+    for (int i = 0; i < ITERATIONS; ++i)
+        file_read_string(SYSFS_FALLBACK, s2, sizeof(s2));
+    t_new = now_ns() - t0;
+    report("sysfs file_read_string", t_old, t_new);
+
+    return 0;
+}